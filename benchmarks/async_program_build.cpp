@@ -0,0 +1,104 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+//Render thread stalls while building PROGRAMS shader variants: synchronous compile/link with a status
+//check per program versus agl::program_builder submitted up front and polled once per simulated frame
+
+#include<cstdlib>
+#include<string>
+#include<vector>
+#include<algorithm>
+
+#include "bench_util.hpp"
+
+constexpr int PROGRAMS = 64;
+
+const char* VERTEX = R"(#version 450 core
+layout(location = 0) in vec3 position;
+uniform mat4 view_projection;
+void main() {
+    gl_Position = view_projection * vec4(position * float(VARIANT + 1), 1);
+}
+)";
+const char* FRAGMENT = R"(#version 450 core
+uniform vec4 color;
+out vec4 result;
+void main() {
+    vec4 value = color;
+    for(int i = 0; i < VARIANT % 8; i++) {
+        value = value * 0.9 + 0.05 * sin(value * float(i));
+    }
+    result = value;
+}
+)";
+
+const agl::shader_source SOURCES[] = {
+    {GL_VERTEX_SHADER, VERTEX},
+    {GL_FRAGMENT_SHADER, FRAGMENT}
+};
+
+static std::string variant_defines(int variant) {
+    return "#define VARIANT " + std::to_string(variant) + "\n";
+}
+
+int main() {
+    //Mesa's on-disk shader cache would make whichever run comes second look free
+    setenv("MESA_SHADER_CACHE_DISABLE", "true", 1);
+    if(!agl_bench::create_headless_context()) {
+        return EXIT_FAILURE;
+    }
+    std::cout << "Parallel shader compile: " << (agl::parallel_shader_compile() ? "yes" : "no") << std::endl;
+
+    //Synchronous, every status query waits for the compiler
+    double sync_worst = 0.0;
+    auto start = agl_bench::clock::now();
+    for(int variant = 0; variant < PROGRAMS; variant++) {
+        auto program_start = agl_bench::clock::now();
+        std::string defines = variant_defines(variant);
+        agl::vertex_shader vertex;
+        agl::fragment_shader fragment;
+        vertex.compile(VERTEX, defines);
+        fragment.compile(FRAGMENT, defines);
+        agl::program prog;
+        prog.attach_shader(vertex);
+        prog.attach_shader(fragment);
+        prog.link();
+        if(!prog.link_success()) {
+            std::cerr << prog.info_log() << std::endl;
+            return EXIT_FAILURE;
+        }
+        sync_worst = std::max(sync_worst, agl_bench::seconds_since(program_start));
+    }
+    double sync_seconds = agl_bench::seconds_since(start);
+
+    //Asynchronous, different variants so nothing is reused from the synchronous run
+    agl::program_builder builder;
+    std::vector<agl::program_future> futures;
+    start = agl_bench::clock::now();
+    for(int variant = PROGRAMS; variant < PROGRAMS * 2; variant++) {
+        futures.push_back(builder.submit(SOURCES, variant_defines(variant)));
+    }
+    double submit_seconds = agl_bench::seconds_since(start);
+
+    int frames = 0;
+    double async_worst = 0.0;
+    while(builder.pending() > 0) {
+        auto frame_start = agl_bench::clock::now();
+        builder.poll();
+        async_worst = std::max(async_worst, agl_bench::seconds_since(frame_start));
+        frames++;
+    }
+    double async_seconds = agl_bench::seconds_since(start);
+
+    for(agl::program_future& future : futures) {
+        if(future.status() != agl::program_future::state::linked) {
+            std::cerr << future.info_log() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::cout << "Synchronous:  " << sync_seconds * 1e3 << " ms total, worst program stall "
+              << sync_worst * 1e3 << " ms" << std::endl;
+    std::cout << "Asynchronous: " << async_seconds * 1e3 << " ms total (" << submit_seconds * 1e3
+              << " ms submitting), " << frames << " polls, worst poll " << async_worst * 1e3 << " ms" << std::endl;
+    return EXIT_SUCCESS;
+}
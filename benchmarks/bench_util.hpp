@@ -0,0 +1,100 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_BENCH_UTIL_HPP
+#define AGL_BENCH_UTIL_HPP
+
+#include<chrono>
+#include<iostream>
+#include<algorithm>
+#include<iterator>
+#include<string_view>
+
+#include "agl/agl.hpp"
+
+#include<EGL/egl.h>
+#include<EGL/eglext.h>
+
+namespace agl_bench {
+
+using clock = std::chrono::steady_clock;
+
+inline double seconds_since(clock::time_point start) {
+    return std::chrono::duration<double>(clock::now() - start).count();
+}
+
+inline EGLDisplay display = EGL_NO_DISPLAY;
+inline EGLContext context = EGL_NO_CONTEXT;
+inline EGLint context_attributes[7] = {};
+
+//Surfaceless contexts sharing objects with the one made by create_headless_context
+inline agl::context_factory headless_context_factory() {
+    agl::context_factory factory{};
+    factory.create = [](void*) -> void* {
+        EGLContext shared = eglCreateContext(display, EGL_NO_CONFIG_KHR, context, context_attributes);
+        return shared != EGL_NO_CONTEXT ? shared : nullptr;
+    };
+    factory.make_current = [](void* shared, void*) -> bool {
+        EGLContext current = shared != nullptr ? static_cast<EGLContext>(shared) : EGL_NO_CONTEXT;
+        return eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, current) == EGL_TRUE;
+    };
+    factory.destroy = [](void* shared, void*) {
+        eglDestroyContext(display, static_cast<EGLContext>(shared));
+    };
+    return factory;
+}
+
+//Surfaceless EGL context so benchmarks run without a window (e.g. on Mesa llvmpipe)
+//true = success
+inline bool create_headless_context(int major = 4, int minor = 5) {
+    auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    display = get_platform_display != nullptr
+        ? get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+        : eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if(display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+        std::cerr << "Error: Failed to initialize an EGL display!" << std::endl;
+        return false;
+    }
+    eglBindAPI(EGL_OPENGL_API);
+
+    const EGLint attributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, major,
+        EGL_CONTEXT_MINOR_VERSION, minor,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    std::copy(std::begin(attributes), std::end(attributes), context_attributes);
+    context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+    if(context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        std::cerr << "Error: Failed to create a headless GL " << major << "." << minor << " context!" << std::endl;
+        return false;
+    }
+    if(!agl::init(reinterpret_cast<agl::load_proc>(eglGetProcAddress), headless_context_factory())) {
+        std::cerr << "Error: agl::init failed!" << std::endl;
+        return false;
+    }
+    std::cout << "Renderer: " << glGetString(GL_RENDERER) << " | " << glGetString(GL_VERSION) << std::endl;
+    return true;
+}
+
+//Compiles and links a vertex + fragment program, defines go after both sources' #version line,
+//logs are printed on failure, true = linked
+inline bool build_program(agl::program& prog, std::string_view vertex_source, std::string_view fragment_source,
+                          std::string_view defines = "") {
+    agl::vertex_shader vertex;
+    agl::fragment_shader fragment;
+    vertex.compile(vertex_source, defines);
+    fragment.compile(fragment_source, defines);
+    prog.attach_shader(vertex);
+    prog.attach_shader(fragment);
+    prog.link();
+    if(!prog.link_success()) {
+        std::cerr << vertex.info_log() << fragment.info_log() << prog.info_log() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}
+
+#endif //AGL_BENCH_UTIL_HPP
@@ -0,0 +1,59 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+//GL calls issued and CPU time per buffer bind, run against the recording stub GL table so only AGL's overhead
+//is measured
+
+#include<cstdlib>
+
+#include "bench_util.hpp"
+#include "gl_recorder.hpp"
+
+namespace recorder = agl_bench::recorder;
+
+constexpr int ITERATIONS = 10000000;
+
+//Only buffers are bound in the measured loops
+static std::uint64_t gl_binds() {
+    return recorder::calls[recorder::bind];
+}
+
+template<typename BODY>
+static void report(const char* name, int binds_per_iteration, BODY body) {
+    recorder::reset();
+    auto start = agl_bench::clock::now();
+    for(int iteration = 0; iteration < ITERATIONS; iteration++) {
+        body(iteration);
+    }
+    double seconds = agl_bench::seconds_since(start);
+    double binds = double(ITERATIONS) * binds_per_iteration;
+    std::cout << name << ": "
+              << seconds * 1e9 / binds << " ns/bind, "
+              << double(gl_binds()) / binds << " GL calls/bind" << std::endl;
+}
+
+int main() {
+    if(!recorder::load_mock()) {
+        std::cerr << "Error: Failed to load the recording GL stub!" << std::endl;
+        return EXIT_FAILURE;
+    }
+    recorder::interpose();
+
+    agl::buffer first;
+    agl::buffer second;
+    agl::buffer camera;
+    agl::buffer material;
+
+    report("redundant bind(GL_ARRAY_BUFFER)", 1, [&](int) {
+        first.bind(GL_ARRAY_BUFFER);
+    });
+    report("alternating bind(GL_ARRAY_BUFFER)", 1, [&](int iteration) {
+        (iteration & 1 ? first : second).bind(GL_ARRAY_BUFFER);
+    });
+    report("draw loop (vertex + element + 2 UBO slots, one changing)", 4, [&](int iteration) {
+        first.bind(GL_ARRAY_BUFFER);
+        second.bind(GL_ELEMENT_ARRAY_BUFFER);
+        camera.bind_base(GL_UNIFORM_BUFFER, 0);
+        material.bind_range(GL_UNIFORM_BUFFER, 1, (iteration & 7) * 256, 256);
+    });
+    return EXIT_SUCCESS;
+}
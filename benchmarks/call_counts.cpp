@@ -0,0 +1,220 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+//GL calls and CPU time per AGL operation for scenarios that exercise redundant call elimination,
+//checked against call budgets (exit code 1 if any budget is exceeded).
+//Runs on the recording stub GL table by default (no GPU needed), --egl runs the same scenarios on a real
+//headless context (e.g. Mesa llvmpipe).
+
+#include<cstdlib>
+#include<cstring>
+#include<functional>
+#include<random>
+#include<string>
+#include<vector>
+
+#include "bench_util.hpp"
+#include "gl_recorder.hpp"
+
+namespace recorder = agl_bench::recorder;
+
+constexpr std::uint64_t UNCHECKED = ~std::uint64_t(0);
+
+struct scenario {
+    const char* name;
+    std::uint64_t operations;
+    //Maximum calls per category over the whole scenario
+    recorder::counts budget;
+    std::function<void()> run;
+};
+
+static recorder::counts budget(std::uint64_t bind, std::uint64_t uniform, std::uint64_t create, std::uint64_t destroy, std::uint64_t draw) {
+    return {bind, uniform, create, destroy, draw};
+}
+
+const char* VERTEX = R"(#version 450 core
+layout(location = 0) in vec2 position;
+void main() {
+    gl_Position = vec4(position, 0, 1);
+}
+)";
+const char* FRAGMENT = R"(#version 450 core
+uniform vec4 color;
+layout(binding = 0) uniform sampler2D albedo;
+out vec4 result;
+void main() {
+    result = color * texture(albedo, vec2(0.5));
+}
+)";
+
+int main(int argc, char** argv) {
+    bool egl = argc > 1 && std::strcmp(argv[1], "--egl") == 0;
+    if(egl) {
+        if(!agl_bench::create_headless_context()) {
+            return EXIT_FAILURE;
+        }
+    } else if(!recorder::load_mock()) {
+        std::cerr << "Error: Failed to load the recording GL stub!" << std::endl;
+        return EXIT_FAILURE;
+    } else {
+        std::cout << "Renderer: " << glGetString(GL_RENDERER) << std::endl;
+    }
+    recorder::interpose();
+
+    constexpr int PROGRAMS = 4;
+    constexpr int MESHES = 4;
+    constexpr int TEXTURES = 4;
+    std::vector<agl::program> programs(PROGRAMS);
+    for(agl::program& prog : programs) {
+        if(!agl_bench::build_program(prog, VERTEX, FRAGMENT)) {
+            return EXIT_FAILURE;
+        }
+    }
+    GLint color = programs[0].uniform_location("color");
+
+    const float positions[] = {-1.0f, -1.0f, 1.0f, -1.0f, 0.0f, 1.0f};
+    const GLuint triangle[] = {0, 1, 2};
+    std::vector<agl::buffer> vertex_buffers(MESHES);
+    std::vector<agl::buffer> index_buffers(MESHES);
+    std::vector<agl::vertex_array> meshes(MESHES);
+    for(int mesh = 0; mesh < MESHES; mesh++) {
+        vertex_buffers[mesh].storage(sizeof(positions), positions, 0);
+        index_buffers[mesh].storage(sizeof(triangle), triangle, 0);
+        meshes[mesh].enable_attrib(0);
+        meshes[mesh].attrib_format(0, 2, GL_FLOAT, false, 0);
+        meshes[mesh].attrib_binding(0, 0);
+        meshes[mesh].vertex_buffer(0, vertex_buffers[mesh], 0, 2 * sizeof(float));
+        meshes[mesh].element_buffer(index_buffers[mesh]);
+    }
+    std::vector<agl::texture_2d> textures(TEXTURES);
+    for(agl::texture_2d& texture : textures) {
+        texture.storage(1, GL_RGBA8, 4, 4);
+    }
+
+    std::mt19937 random(1);
+    std::uniform_int_distribution<int> pick(0, 3);
+    struct scene_draw {
+        int program;
+        int mesh;
+        int texture;
+    };
+    std::vector<scene_draw> scene(10000);
+    for(scene_draw& draw : scene) {
+        draw = {pick(random), pick(random), pick(random)};
+    }
+
+    glEnable(GL_RASTERIZER_DISCARD);
+
+    agl::render_queue queue;
+    agl::draw_batch batch(static_cast<GLuint>(scene.size()));
+    agl::vertex_array_cache vertex_arrays;
+    const agl::vertex_format format({{0, 0, 2, GL_FLOAT, false, false, 0}}, {{2 * sizeof(float), 0}});
+
+    const std::vector<scenario> scenarios = {
+        {"redundant buffer binds", 100000, budget(1, 0, 0, 0, 0), [&] {
+            for(int index = 0; index < 100000; index++) {
+                vertex_buffers[0].bind(GL_ARRAY_BUFFER);
+            }
+        }},
+        {"texture units, unchanged", 100000, budget(8, 0, 0, 0, 0), [&] {
+            for(int index = 0; index < 100000; index++) {
+                textures[index % TEXTURES].bind(index % TEXTURES);
+            }
+        }},
+        {"program rebinds", 100000, budget(1, 0, 0, 0, 0), [&] {
+            for(int index = 0; index < 100000; index++) {
+                programs[1].bind();
+            }
+        }},
+        {"uniform, same value", 100000, budget(1, 1, 0, 0, 0), [&] {
+            programs[0].bind();
+            for(int index = 0; index < 100000; index++) {
+                agl::program::bound::set_uniform(color, glm::vec4(1.0f));
+            }
+        }},
+        {"uniform, new value", 100000, budget(1, 100000, 0, 0, 0), [&] {
+            programs[0].bind();
+            for(int index = 0; index < 100000; index++) {
+                agl::program::bound::set_uniform(color, glm::vec4(float(index)));
+            }
+        }},
+        {"per-draw binds, scene order", scene.size(), budget(UNCHECKED, 0, 0, 0, scene.size()), [&] {
+            for(scene_draw const& draw : scene) {
+                programs[draw.program].bind();
+                meshes[draw.mesh].bind();
+                textures[draw.texture].bind(0);
+                glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, 3, GL_UNSIGNED_INT, nullptr, 1, 0, 0);
+            }
+        }},
+        {"render_queue", scene.size(), budget(PROGRAMS * (1 + MESHES * (1 + TEXTURES)), 0, 0, 0, scene.size()), [&] {
+            agl::any_texture* bound[TEXTURES][1];
+            for(int texture = 0; texture < TEXTURES; texture++) {
+                bound[texture][0] = &textures[texture];
+            }
+            for(scene_draw const& draw : scene) {
+                agl::render_command command{
+                    &programs[draw.program], &meshes[draw.mesh], bound[draw.texture], GL_TRIANGLES, GL_UNSIGNED_INT, 3, 0
+                };
+                queue.submit(0, draw.texture, 0.0f, command);
+            }
+            queue.flush();
+        }},
+        {"draw_batch", scene.size(), budget(UNCHECKED, 0, 0, 0, PROGRAMS * MESHES * TEXTURES), [&] {
+            for(scene_draw const& draw : scene) {
+                batch.add(programs[draw.program], meshes[draw.mesh], &textures[draw.texture],
+                          GL_TRIANGLES, GL_UNSIGNED_INT, {3, 1, 0, 0, 0});
+            }
+            batch.submit();
+            batch.next_frame();
+        }},
+        {"vertex_array_cache", 10000, budget(UNCHECKED, 0, MESHES, 0, 0), [&] {
+            for(int index = 0; index < 10000; index++) {
+                agl::buffer* streams[] = {&vertex_buffers[index % MESHES]};
+                vertex_arrays.get(format, streams, &index_buffers[index % MESHES]).bind();
+            }
+        }},
+        {"buffer churn, immediate", 1000, budget(UNCHECKED, 0, 1000, 1000, 0), [&] {
+            for(int index = 0; index < 1000; index++) {
+                agl::buffer temporary;
+            }
+        }},
+        {"buffer churn, deletion_queue", 1000, budget(UNCHECKED, 0, 1000, 2, 0), [&] {
+            agl::deletion_queue deferred;
+            deferred.install();
+            for(int index = 0; index < 1000; index++) {
+                agl::buffer temporary;
+            }
+            deferred.finish();
+        }},
+    };
+
+    std::cout << (egl ? "Mode: real context (EGL)" : "Mode: recording stub") << std::endl;
+    int failures = 0;
+    for(scenario const& test : scenarios) {
+        recorder::reset();
+        auto start = agl_bench::clock::now();
+        test.run();
+        double seconds = agl_bench::seconds_since(start);
+        recorder::counts counted = recorder::calls;
+
+        std::string line = std::string(test.name) + ":";
+        line.resize(32, ' ');
+        std::cout << line << seconds * 1e9 / test.operations << " ns/op";
+        bool over = false;
+        for(int kind = 0; kind < recorder::CATEGORY_COUNT; kind++) {
+            if(counted[kind] != 0) {
+                std::cout << ", " << counted[kind] << " " << recorder::CATEGORY_NAMES[kind];
+            }
+            if(test.budget[kind] != UNCHECKED && counted[kind] > test.budget[kind]) {
+                std::cout << " (budget " << test.budget[kind] << ")";
+                over = true;
+            }
+        }
+        std::cout << (over ? "  OVER BUDGET" : "") << std::endl;
+        failures += over;
+    }
+    if(failures != 0) {
+        std::cout << failures << " scenario(s) over their call budget" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
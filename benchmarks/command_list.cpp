@@ -0,0 +1,169 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+//OBJECTS objects per frame, each culled against the frustum (CPU work) and drawn with a per-object uniform:
+//traversal and submission on the context's thread versus worker threads recording agl::command_list
+//and the context's thread only executing them
+
+#include<algorithm>
+#include<cstdlib>
+#include<random>
+#include<thread>
+#include<vector>
+
+#include "bench_util.hpp"
+
+constexpr int FRAMES = 20;
+constexpr int OBJECTS = 100000;
+constexpr GLuint TRIANGLES = 64;
+
+const char* VERTEX = R"(#version 450 core
+layout(location = 0) in vec2 position;
+uniform mat4 model;
+void main() {
+    gl_Position = model * vec4(position, 0, 1);
+}
+)";
+const char* FRAGMENT = R"(#version 450 core
+out vec4 result;
+void main() {
+    result = vec4(1);
+}
+)";
+
+struct object {
+    glm::mat4 model;
+    glm::vec3 center;
+    float radius;
+    GLuint first;
+};
+
+//Stand-in for scene traversal: transform the bounding sphere and test it against every frustum plane
+static bool visible(object const& item, glm::mat4 const& view_projection, glm::vec4 const (&planes)[6], glm::mat4& world) {
+    world = view_projection * item.model;
+    glm::vec4 center = item.model * glm::vec4(item.center, 1.0f);
+    for(glm::vec4 const& plane : planes) {
+        if(glm::dot(plane, center) < -item.radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    if(!agl_bench::create_headless_context()) {
+        return EXIT_FAILURE;
+    }
+
+    agl::program prog;
+    if(!agl_bench::build_program(prog, VERTEX, FRAGMENT)) {
+        return EXIT_FAILURE;
+    }
+    GLint model_location = prog.uniform_location("model");
+
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+    std::vector<float> vertices(TRIANGLES * 3 * 2);
+    for(float& value : vertices) {
+        value = coordinate(random);
+    }
+    std::vector<GLuint> indices(TRIANGLES * 3);
+    for(GLuint index = 0; index < indices.size(); index++) {
+        indices[index] = index;
+    }
+    agl::buffer vertex_buffer;
+    agl::buffer index_buffer;
+    vertex_buffer.storage(vertices.size() * sizeof(float), vertices.data(), 0);
+    index_buffer.storage(indices.size() * sizeof(GLuint), indices.data(), 0);
+    agl::vertex_array vao;
+    vao.enable_attrib(0);
+    vao.attrib_format(0, 2, GL_FLOAT, false, 0);
+    vao.attrib_binding(0, 0);
+    vao.vertex_buffer(0, vertex_buffer, 0, 2 * sizeof(float));
+    vao.element_buffer(index_buffer);
+
+    std::uniform_int_distribution<GLuint> pick_triangle(0, TRIANGLES - 1);
+    std::vector<object> scene(OBJECTS);
+    for(object& item : scene) {
+        glm::vec3 position(coordinate(random) * 100.0f, coordinate(random) * 100.0f, coordinate(random) * 100.0f);
+        glm::mat4 model(1.0f);
+        model[3] = glm::vec4(position, 1.0f);
+        item = {model, glm::vec3(0.0f), 1.0f, pick_triangle(random) * 3};
+    }
+    //Box of half extent 60 around the origin, about a fifth of the scene is visible
+    glm::mat4 view_projection(1.0f / 60.0f);
+    view_projection[3][3] = 1.0f;
+    glm::vec4 planes[6];
+    for(int axis = 0; axis < 3; axis++) {
+        glm::vec4 normal(0.0f);
+        normal[axis] = 1.0f;
+        normal.w = 60.0f;
+        planes[axis * 2] = normal;
+        normal[axis] = -1.0f;
+        planes[axis * 2 + 1] = normal;
+    }
+
+    glEnable(GL_RASTERIZER_DISCARD);
+
+    auto start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        prog.bind();
+        vao.bind();
+        for(object const& item : scene) {
+            glm::mat4 world;
+            if(visible(item, view_projection, planes, world)) {
+                agl::program::bound::set_uniform(model_location, world);
+                glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, 3, GL_UNSIGNED_INT,
+                    reinterpret_cast<const void*>(item.first * sizeof(GLuint)), 1, 0, 0);
+            }
+        }
+        glFinish();
+    }
+    double serial_seconds = agl_bench::seconds_since(start);
+
+    unsigned int threads = std::max(2u, std::thread::hardware_concurrency());
+    std::vector<agl::command_list> lists;
+    for(unsigned int index = 0; index < threads; index++) {
+        lists.emplace_back();
+    }
+    double record_seconds = 0.0;
+    size_t commands = 0;
+    start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        auto record_start = agl_bench::clock::now();
+        std::vector<std::thread> workers;
+        for(unsigned int index = 0; index < threads; index++) {
+            workers.emplace_back([&, index]() {
+                agl::command_list& list = lists[index];
+                list.reset();
+                list.bind_program(prog);
+                list.bind_vertex_array(vao);
+                size_t begin = OBJECTS * size_t(index) / threads;
+                size_t end = OBJECTS * size_t(index + 1) / threads;
+                for(size_t item = begin; item < end; item++) {
+                    glm::mat4 world;
+                    if(visible(scene[item], view_projection, planes, world)) {
+                        list.set_uniform(model_location, world);
+                        list.draw_elements(GL_TRIANGLES, 3, GL_UNSIGNED_INT, scene[item].first);
+                    }
+                }
+            });
+        }
+        for(std::thread& worker : workers) {
+            worker.join();
+        }
+        record_seconds += agl_bench::seconds_since(record_start);
+        for(agl::command_list const& list : lists) {
+            list.execute();
+            commands += list.size();
+        }
+        glFinish();
+    }
+    double parallel_seconds = agl_bench::seconds_since(start);
+
+    std::cout << FRAMES << " frames of " << OBJECTS << " culled objects" << std::endl;
+    std::cout << "Context thread only: " << serial_seconds * 1e3 / FRAMES << " ms/frame" << std::endl;
+    std::cout << threads << " recording threads: " << parallel_seconds * 1e3 / FRAMES << " ms/frame ("
+              << record_seconds * 1e3 / FRAMES << " ms recording), " << commands / FRAMES << " commands per frame, "
+              << lists[0].memory_used() / 1024 << " KiB per list" << std::endl;
+    return EXIT_SUCCESS;
+}
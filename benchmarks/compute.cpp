@@ -0,0 +1,156 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+//PARTICLES particles integrated and drawn as points for FRAMES frames: on the CPU and uploaded every frame,
+//versus an agl::compute_dispatcher kernel writing the storage buffer the draw then pulls vertices from
+//(barrier_tracker inserting only the barriers the write-to-read hazards need)
+
+#include<cstdlib>
+#include<vector>
+
+#include "bench_util.hpp"
+
+constexpr int PARTICLES = 1 << 18;
+constexpr int FRAMES = 60;
+constexpr float STEP = 1.0f / 60.0f;
+
+struct particle {
+    glm::vec4 position;
+    glm::vec4 velocity;
+};
+
+const char* INTEGRATE = R"(#version 450 core
+layout(local_size_x = 256) in;
+struct particle {
+    vec4 position;
+    vec4 velocity;
+};
+layout(std430, binding = 0) buffer particles {
+    particle items[];
+};
+uniform float step;
+void main() {
+    uint index = gl_GlobalInvocationID.x;
+    if(index >= items.length()) {
+        return;
+    }
+    particle p = items[index];
+    p.velocity.y -= 9.81 * step;
+    p.position.xyz += p.velocity.xyz * step;
+    if(p.position.y < -1.0) {
+        p.position.y = -1.0;
+        p.velocity.y = -p.velocity.y * 0.8;
+    }
+    items[index] = p;
+}
+)";
+const char* VERTEX = R"(#version 450 core
+layout(location = 0) in vec4 position;
+void main() {
+    gl_Position = vec4(position.xyz, 1);
+    gl_PointSize = 1.0;
+}
+)";
+const char* FRAGMENT = R"(#version 450 core
+out vec4 color;
+void main() {
+    color = vec4(1);
+}
+)";
+
+static void integrate(std::vector<particle>& particles) {
+    for(particle& p : particles) {
+        p.velocity.y -= 9.81f * STEP;
+        p.position.x += p.velocity.x * STEP;
+        p.position.y += p.velocity.y * STEP;
+        p.position.z += p.velocity.z * STEP;
+        if(p.position.y < -1.0f) {
+            p.position.y = -1.0f;
+            p.velocity.y = -p.velocity.y * 0.8f;
+        }
+    }
+}
+
+int main() {
+    if(!agl_bench::create_headless_context()) {
+        return EXIT_FAILURE;
+    }
+
+    agl::program kernel_program;
+    {
+        agl::compute_shader shader;
+        shader.compile(INTEGRATE);
+        kernel_program.attach_shader(shader);
+        kernel_program.link();
+        if(!kernel_program.link_success()) {
+            std::cerr << kernel_program.info_log() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    agl::program points;
+    if(!agl_bench::build_program(points, VERTEX, FRAGMENT)) {
+        return EXIT_FAILURE;
+    }
+    agl::compute_kernel kernel(kernel_program);
+
+    std::vector<particle> initial(PARTICLES);
+    for(int index = 0; index < PARTICLES; index++) {
+        float spread = static_cast<float>(index) / PARTICLES;
+        initial[index] = {glm::vec4(spread * 2.0f - 1.0f, 1.0f, 0.0f, 1.0f), glm::vec4(0.0f, spread, 0.0f, 0.0f)};
+    }
+
+    agl::buffer particles;
+    particles.storage(sizeof(particle) * PARTICLES, initial.data(), GL_DYNAMIC_STORAGE_BIT);
+    agl::vertex_array vao;
+    vao.enable_attrib(0);
+    vao.attrib_format(0, 4, GL_FLOAT, false, 0);
+    vao.attrib_binding(0, 0);
+    vao.vertex_buffer(0, particles, 0, sizeof(particle));
+
+    agl::texture_2d color;
+    color.storage(1, GL_RGBA8, 256, 256);
+    agl::framebuffer target;
+    target.attach(GL_COLOR_ATTACHMENT0, color);
+    target.bind();
+    glViewport(0, 0, 256, 256);
+    glEnable(GL_PROGRAM_POINT_SIZE);
+
+    auto draw = [&] {
+        points.bind();
+        vao.bind();
+        glDrawArrays(GL_POINTS, 0, PARTICLES);
+    };
+
+    std::vector<particle> cpu = initial;
+    auto start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        integrate(cpu);
+        particles.sub_data(0, sizeof(particle) * PARTICLES, cpu.data());
+        draw();
+    }
+    glFinish();
+    double cpu_time = agl_bench::seconds_since(start);
+
+    particles.sub_data(0, sizeof(particle) * PARTICLES, initial.data());
+    agl::compute_dispatcher dispatcher;
+    agl::storage_view<particle> view(particles, PARTICLES);
+    dispatcher.bind_storage(0, view, agl::storage_access::read_write);
+    GLint step = kernel_program.uniform_location("step");
+    start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        kernel_program.bind();
+        agl::program::bound::set_uniform(step, STEP);
+        dispatcher.dispatch_threads(kernel, glm::uvec3(PARTICLES, 1, 1));
+        dispatcher.barriers().read(particles, GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+        draw();
+    }
+    glFinish();
+    double gpu_time = agl_bench::seconds_since(start);
+    agl::barrier_tracker::statistics barriers = dispatcher.barriers().stats();
+
+    std::cout << PARTICLES << " particles, " << FRAMES << " frames" << std::endl;
+    std::cout << "CPU integrate + upload:  " << cpu_time * 1e3 / FRAMES << " ms/frame" << std::endl;
+    std::cout << "compute_dispatcher:      " << gpu_time * 1e3 / FRAMES << " ms/frame, local size "
+              << kernel.local_size().x << ", " << dispatcher.dispatches() << " dispatches, "
+              << barriers.barriers << " barriers, " << barriers.skipped << " reads without one" << std::endl;
+    return EXIT_SUCCESS;
+}
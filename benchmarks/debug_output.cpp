@@ -0,0 +1,71 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+//Render thread time spent on MESSAGES synchronous debug messages (DISTINCT different ones, repeated):
+//a callback formatting and writing each to std::cerr versus agl::debug_output (ring + drain thread + dedup).
+//Run with 2>/dev/null to leave only the results
+
+#include<cstdlib>
+#include<format>
+#include<string>
+
+#include "bench_util.hpp"
+
+constexpr int MESSAGES = 20000;
+constexpr int DISTINCT = 50;
+
+static void GLAPIENTRY write_each(GLenum, GLenum type, GLuint, GLenum severity,
+                                  GLsizei, const GLchar* message, const void*) {
+    std::cerr << std::format("GL CALLBACK: {} type = 0x{:x}, severity = 0x{:x}, message = {}",
+                             type == GL_DEBUG_TYPE_ERROR ? "** GL ERROR **" : "", type, severity, message) << std::endl;
+}
+
+static double insert_messages() {
+    std::string texts[DISTINCT];
+    for(int index = 0; index < DISTINCT; index++) {
+        texts[index] = std::format("Buffer object {} will use VIDEO memory as the source for buffer object operations", index);
+    }
+    auto start = agl_bench::clock::now();
+    for(int index = 0; index < MESSAGES; index++) {
+        std::string const& text = texts[index % DISTINCT];
+        glDebugMessageInsert(GL_DEBUG_SOURCE_APPLICATION, GL_DEBUG_TYPE_PERFORMANCE, index % DISTINCT,
+                             GL_DEBUG_SEVERITY_MEDIUM, static_cast<GLsizei>(text.size()), text.c_str());
+    }
+    return agl_bench::seconds_since(start);
+}
+
+int main() {
+    if(!agl_bench::create_headless_context()) {
+        return EXIT_FAILURE;
+    }
+
+    glEnable(GL_DEBUG_OUTPUT);
+    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    glDebugMessageCallback(&write_each, nullptr);
+    double immediate = insert_messages();
+    glDebugMessageCallback(nullptr, nullptr);
+    glDisable(GL_DEBUG_OUTPUT);
+
+    agl::debug_output::summary frame;
+    agl::debug_output::summary total;
+    double ring;
+    double drain;
+    {
+        agl::debug_output::config settings;
+        settings.synchronous = true;
+        agl::debug_output output(settings);
+        output.enable();
+        ring = insert_messages();
+        frame = output.end_frame();
+        auto start = agl_bench::clock::now();
+        output.drain();
+        drain = agl_bench::seconds_since(start);
+        total = output.totals();
+    }
+
+    std::cout << MESSAGES << " messages, " << DISTINCT << " distinct" << std::endl;
+    std::cout << "Format + std::cerr per message: " << immediate * 1e3 << " ms on the render thread" << std::endl;
+    std::cout << "debug_output:                   " << ring * 1e3 << " ms on the render thread, "
+              << drain * 1e3 << " ms waiting for the drain thread, " << frame.messages << " messages this frame, "
+              << total.duplicates << " duplicates and " << total.dropped << " dropped" << std::endl;
+    return EXIT_SUCCESS;
+}
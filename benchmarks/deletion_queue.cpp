@@ -0,0 +1,119 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+//Unloading a scene of OBJECTS meshes (vertex buffer, index buffer, vertex array, texture each) right after
+//drawing them: destructors deleting one name at a time versus an installed agl::deletion_queue
+//(destructors only enqueue, later flushes delete in bulk once the GPU retired the frame)
+
+#include<cstdlib>
+#include<memory>
+#include<vector>
+
+#include "bench_util.hpp"
+
+constexpr int ROUNDS = 5;
+constexpr int OBJECTS = 4000;
+
+struct mesh {
+    agl::buffer vertices;
+    agl::buffer indices;
+    agl::vertex_array vao;
+    agl::texture_2d texture;
+};
+
+static std::vector<std::unique_ptr<mesh>> load_scene() {
+    const float positions[] = {-1.0f, -1.0f, 1.0f, -1.0f, 0.0f, 1.0f};
+    const GLushort triangle[] = {0, 1, 2};
+    const std::uint32_t texels[16] = {};
+    std::vector<std::unique_ptr<mesh>> scene;
+    scene.reserve(OBJECTS);
+    for(int index = 0; index < OBJECTS; index++) {
+        auto& added = scene.emplace_back(std::make_unique<mesh>());
+        added->vertices.storage(sizeof(positions), positions, 0);
+        added->indices.storage(sizeof(triangle), triangle, 0);
+        added->vao.enable_attrib(0);
+        added->vao.attrib_format(0, 2, GL_FLOAT, false, 0);
+        added->vao.attrib_binding(0, 0);
+        added->vao.vertex_buffer(0, added->vertices, 0, 2 * sizeof(float));
+        added->vao.element_buffer(added->indices);
+        added->texture.storage(1, GL_RGBA8, 4, 4);
+        added->texture.sub_image(0, 0, 0, 4, 4, GL_RGBA, GL_UNSIGNED_BYTE, texels);
+    }
+    return scene;
+}
+
+static void draw_scene(std::vector<std::unique_ptr<mesh>>& scene) {
+    for(auto& item : scene) {
+        item->vao.bind();
+        item->texture.bind(0);
+        glDrawElements(GL_TRIANGLES, 3, GL_UNSIGNED_SHORT, nullptr);
+    }
+}
+
+int main() {
+    if(!agl_bench::create_headless_context()) {
+        return EXIT_FAILURE;
+    }
+
+    agl::program prog;
+    {
+        agl::vertex_shader vertex;
+        agl::fragment_shader fragment;
+        vertex.compile("#version 450 core\nlayout(location = 0) in vec2 p;\nvoid main() {gl_Position = vec4(p, 0, 1);}\n");
+        fragment.compile("#version 450 core\nlayout(binding = 0) uniform sampler2D t;\nout vec4 r;\nvoid main() {r = texture(t, vec2(0.5));}\n");
+        prog.attach_shader(vertex);
+        prog.attach_shader(fragment);
+        prog.link();
+        if(!prog.link_success()) {
+            std::cerr << prog.info_log() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    prog.bind();
+    agl::texture_2d color;
+    color.storage(1, GL_RGBA8, 256, 256);
+    agl::framebuffer target;
+    target.attach(GL_COLOR_ATTACHMENT0, color);
+    target.bind();
+    glViewport(0, 0, 256, 256);
+
+    double immediate_unload = 0.0;
+    for(int round = 0; round < ROUNDS; round++) {
+        auto scene = load_scene();
+        draw_scene(scene);
+        glFlush();
+        auto start = agl_bench::clock::now();
+        scene.clear();
+        immediate_unload += agl_bench::seconds_since(start);
+        glFinish();
+    }
+
+    double deferred_unload = 0.0;
+    double deferred_flush = 0.0;
+    agl::deletion_queue queue;
+    queue.install();
+    for(int round = 0; round < ROUNDS; round++) {
+        auto scene = load_scene();
+        draw_scene(scene);
+        glFlush();
+        auto start = agl_bench::clock::now();
+        scene.clear();
+        deferred_unload += agl_bench::seconds_since(start);
+
+        //Frames go on, the batch is deleted by the first flush after its fence signals
+        start = agl_bench::clock::now();
+        queue.flush();
+        glFinish();
+        queue.flush();
+        deferred_flush += agl_bench::seconds_since(start);
+    }
+    agl::deletion_queue::statistics stats = queue.stats();
+    queue.uninstall();
+
+    std::cout << ROUNDS << " unloads of " << OBJECTS << " meshes (" << OBJECTS * 4 << " objects)" << std::endl;
+    std::cout << "Immediate glDelete*: " << immediate_unload * 1e3 / ROUNDS << " ms/unload in destructors" << std::endl;
+    std::cout << "deletion_queue:      " << deferred_unload * 1e3 / ROUNDS << " ms/unload in destructors, "
+              << deferred_flush * 1e3 / ROUNDS << " ms/unload flushing (incl. glFinish), "
+              << stats.deleted << " names deleted with " << stats.delete_calls << " glDelete* calls, "
+              << queue.pending() << " pending" << std::endl;
+    return EXIT_SUCCESS;
+}
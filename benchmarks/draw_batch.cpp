@@ -0,0 +1,156 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+//DRAWS small indexed draws per frame over a mix of programs, vertex arrays and textures in scene order:
+//one glDrawElements* call per draw (binds cached) versus agl::draw_batch sorting them into multi-draw indirect runs
+
+#include<cstdlib>
+#include<random>
+#include<string>
+#include<vector>
+
+#include "bench_util.hpp"
+
+constexpr int FRAMES = 20;
+constexpr int DRAWS = 100000;
+constexpr int PROGRAMS = 4;
+constexpr int MESHES = 8;
+constexpr int TEXTURES = 8;
+constexpr GLuint TRIANGLES_PER_MESH = 64;
+
+const char* VERTEX = R"(#version 450 core
+layout(location = 0) in vec2 position;
+void main() {
+    gl_Position = vec4(position * SCALE, 0, 1);
+}
+)";
+const char* FRAGMENT = R"(#version 450 core
+layout(binding = 0) uniform sampler2D albedo;
+out vec4 result;
+void main() {
+    result = texture(albedo, vec2(0.5));
+}
+)";
+
+struct scene_draw {
+    int program;
+    int mesh;
+    int texture;
+    agl::draw_elements_command command;
+};
+
+int main() {
+    if(!agl_bench::create_headless_context()) {
+        return EXIT_FAILURE;
+    }
+
+    std::vector<agl::program> programs(PROGRAMS);
+    for(int index = 0; index < PROGRAMS; index++) {
+        //Distinct programs with the same interface
+        std::string defines = "#define SCALE " + std::to_string(1.0f / (index + 1)) + "\n";
+        if(!agl_bench::build_program(programs[index], VERTEX, FRAGMENT, defines)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+    std::vector<float> vertices(TRIANGLES_PER_MESH * 3 * 2);
+    std::vector<GLuint> indices(TRIANGLES_PER_MESH * 3);
+    for(GLuint index = 0; index < indices.size(); index++) {
+        indices[index] = index;
+    }
+
+    std::vector<agl::buffer> vertex_buffers(MESHES);
+    std::vector<agl::buffer> index_buffers(MESHES);
+    std::vector<agl::vertex_array> meshes(MESHES);
+    for(int mesh = 0; mesh < MESHES; mesh++) {
+        for(float& value : vertices) {
+            value = coordinate(random);
+        }
+        vertex_buffers[mesh].storage(vertices.size() * sizeof(float), vertices.data(), 0);
+        index_buffers[mesh].storage(indices.size() * sizeof(GLuint), indices.data(), 0);
+        meshes[mesh].enable_attrib(0);
+        meshes[mesh].attrib_format(0, 2, GL_FLOAT, false, 0);
+        meshes[mesh].attrib_binding(0, 0);
+        meshes[mesh].vertex_buffer(0, vertex_buffers[mesh], 0, 2 * sizeof(float));
+        meshes[mesh].element_buffer(index_buffers[mesh]);
+    }
+
+    std::vector<agl::texture_2d> textures(TEXTURES);
+    for(agl::texture_2d& texture : textures) {
+        texture.storage(1, GL_RGBA8, 4, 4);
+    }
+
+    std::uniform_int_distribution<int> pick_program(0, PROGRAMS - 1);
+    std::uniform_int_distribution<int> pick_mesh(0, MESHES - 1);
+    std::uniform_int_distribution<int> pick_texture(0, TEXTURES - 1);
+    std::uniform_int_distribution<GLuint> pick_triangle(0, TRIANGLES_PER_MESH - 1);
+    std::vector<scene_draw> scene(DRAWS);
+    for(scene_draw& draw : scene) {
+        draw = {pick_program(random), pick_mesh(random), pick_texture(random), {3, 1, pick_triangle(random) * 3, 0, 0}};
+    }
+
+    //Measures submission, not fill
+    glEnable(GL_RASTERIZER_DISCARD);
+
+    double direct_submit = 0.0;
+    auto start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        auto submit_start = agl_bench::clock::now();
+        for(scene_draw const& draw : scene) {
+            programs[draw.program].bind();
+            meshes[draw.mesh].bind();
+            textures[draw.texture].bind(0);
+            glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, draw.command.count, GL_UNSIGNED_INT,
+                reinterpret_cast<const void*>(draw.command.first_index * sizeof(GLuint)),
+                draw.command.instance_count, draw.command.base_vertex, draw.command.base_instance);
+        }
+        direct_submit += agl_bench::seconds_since(submit_start);
+        glFinish();
+    }
+    double direct_seconds = agl_bench::seconds_since(start);
+
+    auto run_batched = [&](bool indirect_count, double& submit_seconds, agl::draw_batch::statistics& stats) {
+        agl::draw_batch batch(DRAWS);
+        batch.use_indirect_count(indirect_count);
+        submit_seconds = 0.0;
+        auto batched_start = agl_bench::clock::now();
+        for(int frame = 0; frame < FRAMES; frame++) {
+            auto submit_start = agl_bench::clock::now();
+            for(scene_draw const& draw : scene) {
+                batch.add(programs[draw.program], meshes[draw.mesh], &textures[draw.texture],
+                          GL_TRIANGLES, GL_UNSIGNED_INT, draw.command);
+            }
+            batch.submit();
+            batch.next_frame();
+            submit_seconds += agl_bench::seconds_since(submit_start);
+            glFinish();
+        }
+        stats = batch.stats();
+        return agl_bench::seconds_since(batched_start);
+    };
+
+    double batched_submit = 0.0;
+    agl::draw_batch::statistics batched_stats;
+    double batched_seconds = run_batched(false, batched_submit, batched_stats);
+
+    std::cout << FRAMES << " frames of " << DRAWS << " draws (" << PROGRAMS << " programs, " << MESHES
+              << " vertex arrays, " << TEXTURES << " textures)" << std::endl;
+    std::cout << "Per-draw calls: " << direct_submit * 1e3 / FRAMES << " ms/frame submit, "
+              << direct_seconds * 1e3 / FRAMES << " ms/frame to finish" << std::endl;
+    std::cout << "draw_batch MDI: " << batched_submit * 1e3 / FRAMES << " ms/frame submit, "
+              << batched_seconds * 1e3 / FRAMES << " ms/frame to finish, "
+              << batched_stats.multi_draws / FRAMES << " multi-draws and " << batched_stats.state_changes / FRAMES
+              << " state changes per frame, " << batched_stats.overflow_draws << " overflow draws" << std::endl;
+
+    if(agl::indirect_parameters()) {
+        double count_submit = 0.0;
+        agl::draw_batch::statistics count_stats;
+        double count_seconds = run_batched(true, count_submit, count_stats);
+        std::cout << "draw_batch MDI count: " << count_submit * 1e3 / FRAMES << " ms/frame submit, "
+                  << count_seconds * 1e3 / FRAMES << " ms/frame to finish" << std::endl;
+    } else {
+        std::cout << "draw_batch MDI count: not supported" << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
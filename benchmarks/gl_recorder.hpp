@@ -0,0 +1,323 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_GL_RECORDER_HPP
+#define AGL_GL_RECORDER_HPP
+
+#include<algorithm>
+#include<array>
+#include<vector>
+#include<memory>
+#include<string_view>
+#include<cstddef>
+#include<cstdint>
+#include<cstring>
+#include<type_traits>
+
+#include "agl/agl.hpp"
+
+//Counts the GL calls AGL makes by swapping GLAD's function pointers for counting thunks after init,
+//either over a real context or over a stub function table (load_mock) that needs no GPU or window system
+namespace agl_bench::recorder {
+
+enum category {
+    bind,
+    uniform,
+    create,
+    destroy,
+    draw,
+    CATEGORY_COUNT
+};
+inline const char* const CATEGORY_NAMES[CATEGORY_COUNT] = {"bind", "uniform", "create", "delete", "draw"};
+
+using counts = std::array<std::uint64_t, CATEGORY_COUNT>;
+inline counts calls{};
+
+inline void reset() {
+    calls = {};
+}
+
+template<auto& POINTER, typename = std::remove_reference_t<decltype(POINTER)>>
+struct counted;
+
+template<auto& POINTER, typename R, typename... A>
+struct counted<POINTER, R (APIENTRYP)(A...)> {
+    inline static R (APIENTRYP real)(A...) = nullptr;
+    inline static category kind = bind;
+
+    static R APIENTRY thunk(A... args) {
+        calls[kind]++;
+        return real(args...);
+    }
+    static void install(category counted_as) {
+        if(POINTER != nullptr && POINTER != &thunk) {
+            real = POINTER;
+            kind = counted_as;
+            POINTER = &thunk;
+        }
+    }
+};
+
+#define AGL_RECORD(NAME, CATEGORY) counted<glad_##NAME>::install(CATEGORY)
+
+//Call after agl::init, counts from then on
+inline void interpose() {
+    AGL_RECORD(glBindBuffer, bind);
+    AGL_RECORD(glBindBufferBase, bind);
+    AGL_RECORD(glBindBufferRange, bind);
+    AGL_RECORD(glBindVertexArray, bind);
+    AGL_RECORD(glBindVertexBuffer, bind);
+    AGL_RECORD(glBindTexture, bind);
+    AGL_RECORD(glBindTextureUnit, bind);
+    AGL_RECORD(glBindTextures, bind);
+    AGL_RECORD(glActiveTexture, bind);
+    AGL_RECORD(glBindSampler, bind);
+    AGL_RECORD(glBindSamplers, bind);
+    AGL_RECORD(glBindFramebuffer, bind);
+    AGL_RECORD(glBindRenderbuffer, bind);
+    AGL_RECORD(glBindProgramPipeline, bind);
+    AGL_RECORD(glBindTransformFeedback, bind);
+    AGL_RECORD(glUseProgram, bind);
+
+    AGL_RECORD(glUniform1f, uniform);
+    AGL_RECORD(glUniform2f, uniform);
+    AGL_RECORD(glUniform3f, uniform);
+    AGL_RECORD(glUniform4f, uniform);
+    AGL_RECORD(glUniform1i, uniform);
+    AGL_RECORD(glUniform2i, uniform);
+    AGL_RECORD(glUniform3i, uniform);
+    AGL_RECORD(glUniform4i, uniform);
+    AGL_RECORD(glUniform1ui, uniform);
+    AGL_RECORD(glUniform2ui, uniform);
+    AGL_RECORD(glUniform3ui, uniform);
+    AGL_RECORD(glUniform4ui, uniform);
+    AGL_RECORD(glUniform1fv, uniform);
+    AGL_RECORD(glUniform2fv, uniform);
+    AGL_RECORD(glUniform3fv, uniform);
+    AGL_RECORD(glUniform4fv, uniform);
+    AGL_RECORD(glUniform1iv, uniform);
+    AGL_RECORD(glUniform2iv, uniform);
+    AGL_RECORD(glUniform3iv, uniform);
+    AGL_RECORD(glUniform4iv, uniform);
+    AGL_RECORD(glUniform1uiv, uniform);
+    AGL_RECORD(glUniform2uiv, uniform);
+    AGL_RECORD(glUniform3uiv, uniform);
+    AGL_RECORD(glUniform4uiv, uniform);
+    AGL_RECORD(glUniformMatrix2fv, uniform);
+    AGL_RECORD(glUniformMatrix3fv, uniform);
+    AGL_RECORD(glUniformMatrix4fv, uniform);
+    AGL_RECORD(glUniformMatrix2x3fv, uniform);
+    AGL_RECORD(glUniformMatrix3x2fv, uniform);
+    AGL_RECORD(glUniformMatrix2x4fv, uniform);
+    AGL_RECORD(glUniformMatrix4x2fv, uniform);
+    AGL_RECORD(glUniformMatrix3x4fv, uniform);
+    AGL_RECORD(glUniformMatrix4x3fv, uniform);
+
+    AGL_RECORD(glGenBuffers, create);
+    AGL_RECORD(glGenVertexArrays, create);
+    AGL_RECORD(glGenTextures, create);
+    AGL_RECORD(glGenSamplers, create);
+    AGL_RECORD(glGenFramebuffers, create);
+    AGL_RECORD(glGenRenderbuffers, create);
+    AGL_RECORD(glGenQueries, create);
+    AGL_RECORD(glGenProgramPipelines, create);
+    AGL_RECORD(glGenTransformFeedbacks, create);
+    AGL_RECORD(glCreateBuffers, create);
+    AGL_RECORD(glCreateVertexArrays, create);
+    AGL_RECORD(glCreateTextures, create);
+    AGL_RECORD(glCreateSamplers, create);
+    AGL_RECORD(glCreateFramebuffers, create);
+    AGL_RECORD(glCreateRenderbuffers, create);
+    AGL_RECORD(glCreateQueries, create);
+    AGL_RECORD(glCreateProgramPipelines, create);
+    AGL_RECORD(glCreateTransformFeedbacks, create);
+    AGL_RECORD(glCreateShader, create);
+    AGL_RECORD(glCreateProgram, create);
+
+    AGL_RECORD(glDeleteBuffers, destroy);
+    AGL_RECORD(glDeleteVertexArrays, destroy);
+    AGL_RECORD(glDeleteTextures, destroy);
+    AGL_RECORD(glDeleteSamplers, destroy);
+    AGL_RECORD(glDeleteFramebuffers, destroy);
+    AGL_RECORD(glDeleteRenderbuffers, destroy);
+    AGL_RECORD(glDeleteQueries, destroy);
+    AGL_RECORD(glDeleteProgramPipelines, destroy);
+    AGL_RECORD(glDeleteTransformFeedbacks, destroy);
+    AGL_RECORD(glDeleteShader, destroy);
+    AGL_RECORD(glDeleteProgram, destroy);
+    AGL_RECORD(glDeleteSync, destroy);
+
+    AGL_RECORD(glDrawArrays, draw);
+    AGL_RECORD(glDrawElements, draw);
+    AGL_RECORD(glDrawArraysInstancedBaseInstance, draw);
+    AGL_RECORD(glDrawElementsInstancedBaseVertexBaseInstance, draw);
+    AGL_RECORD(glMultiDrawElementsIndirect, draw);
+    AGL_RECORD(glMultiDrawElementsIndirectCount, draw);
+    AGL_RECORD(glMultiDrawElementsIndirectCountARB, draw);
+}
+
+#undef AGL_RECORD
+
+//Stub GL 4.6 context: names are handed out in order, compiles and links succeed, every program
+//reflects a single "uniform vec4 color" at location 0, fences are signaled and maps return host memory.
+//Every entry point AGL calls that returns a value has a stub with its exact signature below, everything else
+//is a void no-op (arguments are ignored, callers clean the stack on every supported ABI).
+namespace mock {
+
+inline GLuint next_name = 1;
+inline std::vector<std::unique_ptr<std::byte[]>> mappings;
+
+inline void APIENTRY no_op() {}
+
+inline const GLubyte* APIENTRY get_string(GLenum name) {
+    switch(name) {
+        case GL_VERSION: return reinterpret_cast<const GLubyte*>("4.6.0 AGL recording mock");
+        case GL_RENDERER: return reinterpret_cast<const GLubyte*>("AGL recording mock");
+        case GL_VENDOR: return reinterpret_cast<const GLubyte*>("AGL");
+        case GL_SHADING_LANGUAGE_VERSION: return reinterpret_cast<const GLubyte*>("4.60");
+        default: return nullptr;
+    }
+}
+inline const GLubyte* APIENTRY get_stringi(GLenum, GLuint) {
+    return nullptr;
+}
+inline void APIENTRY get_integer(GLenum name, GLint* data) {
+    switch(name) {
+        case GL_PACK_ALIGNMENT: case GL_UNPACK_ALIGNMENT: *data = 4; break;
+        case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT: case GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT: *data = 256; break;
+        case GL_MAX_TEXTURE_IMAGE_UNITS: case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS: *data = 32; break;
+        default: *data = 0; break;
+    }
+}
+inline void APIENTRY gen_names(GLsizei count, GLuint* names) {
+    for(GLsizei index = 0; index < count; index++) {
+        names[index] = next_name++;
+    }
+}
+inline void APIENTRY create_targeted_names(GLenum, GLsizei count, GLuint* names) {
+    gen_names(count, names);
+}
+inline GLuint APIENTRY create_shader(GLenum) {
+    return next_name++;
+}
+inline GLuint APIENTRY create_program() {
+    return next_name++;
+}
+inline void APIENTRY get_shader(GLuint, GLenum name, GLint* value) {
+    *value = name == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+inline void APIENTRY get_program(GLuint, GLenum name, GLint* value) {
+    *value = name == GL_LINK_STATUS || name == GL_COMPLETION_STATUS_KHR ? GL_TRUE : 0;
+}
+inline void APIENTRY get_program_interface(GLuint, GLenum interface, GLenum name, GLint* value) {
+    *value = 0;
+    if(interface == GL_UNIFORM) {
+        *value = name == GL_ACTIVE_RESOURCES ? 1 : name == GL_MAX_NAME_LENGTH ? 6 : 0;
+    }
+}
+inline void APIENTRY get_program_resource(GLuint, GLenum, GLuint, GLsizei count, const GLenum* properties,
+                                          GLsizei, GLsizei* length, GLint* values) {
+    for(GLsizei index = 0; index < count; index++) {
+        switch(properties[index]) {
+            case GL_TYPE: values[index] = GL_FLOAT_VEC4; break;
+            case GL_ARRAY_SIZE: values[index] = 1; break;
+            case GL_BLOCK_INDEX: case GL_OFFSET: values[index] = -1; break;
+            default: values[index] = 0; break;
+        }
+    }
+    if(length != nullptr) {
+        *length = count;
+    }
+}
+inline GLuint APIENTRY get_program_resource_index(GLuint, GLenum, const GLchar*) {
+    return GL_INVALID_INDEX;
+}
+inline GLint APIENTRY get_uniform_location(GLuint, const GLchar* name) {
+    return std::string_view(name) == "color" ? 0 : -1;
+}
+inline void APIENTRY get_program_resource_name(GLuint, GLenum, GLuint, GLsizei size, GLsizei* length, GLchar* name) {
+    GLsizei written = std::min<GLsizei>(size - 1, 5);
+    std::memcpy(name, "color", written);
+    name[written] = '\0';
+    if(length != nullptr) {
+        *length = written;
+    }
+}
+inline GLsync APIENTRY fence_sync(GLenum, GLbitfield) {
+    return reinterpret_cast<GLsync>(std::uintptr_t(1));
+}
+inline GLenum APIENTRY client_wait_sync(GLsync, GLbitfield, GLuint64) {
+    return GL_ALREADY_SIGNALED;
+}
+inline void APIENTRY get_sync(GLsync, GLenum, GLsizei, GLsizei* length, GLint* values) {
+    *values = GL_SIGNALED;
+    if(length != nullptr) {
+        *length = 1;
+    }
+}
+inline void* APIENTRY map_range(GLenum, GLintptr, GLsizeiptr length, GLbitfield) {
+    return mappings.emplace_back(std::make_unique<std::byte[]>(length)).get();
+}
+inline void* APIENTRY map_named_range(GLuint, GLintptr, GLsizeiptr length, GLbitfield) {
+    return map_range(0, 0, length, 0);
+}
+inline GLboolean APIENTRY unmap(GLenum) {
+    return GL_TRUE;
+}
+inline GLenum APIENTRY framebuffer_status(GLenum) {
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+inline GLenum APIENTRY named_framebuffer_status(GLuint, GLenum) {
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+inline void APIENTRY get_query_object(GLuint, GLenum, GLuint* value) {
+    *value = 1;
+}
+inline GLuint64 APIENTRY get_texture_handle(GLuint texture) {
+    return texture;
+}
+inline GLuint64 APIENTRY get_texture_sampler_handle(GLuint texture, GLuint) {
+    return texture;
+}
+
+inline void* load(const char* name) {
+    std::string_view function(name);
+    auto proc = [](auto pointer) {return reinterpret_cast<void*>(pointer);};
+    if(function == "glGetString") return proc(&get_string);
+    if(function == "glGetStringi") return proc(&get_stringi);
+    if(function == "glGetIntegerv") return proc(&get_integer);
+    if(function == "glCreateTextures" || function == "glCreateQueries") return proc(&create_targeted_names);
+    if(function.starts_with("glGenerate")) return proc(&no_op);
+    if(function.starts_with("glGen") || (function.starts_with("glCreate") && function.ends_with("s"))) return proc(&gen_names);
+    if(function == "glCreateShader") return proc(&create_shader);
+    if(function == "glCreateProgram") return proc(&create_program);
+    if(function == "glGetShaderiv") return proc(&get_shader);
+    if(function == "glGetProgramiv") return proc(&get_program);
+    if(function == "glGetProgramInterfaceiv") return proc(&get_program_interface);
+    if(function == "glGetProgramResourceiv") return proc(&get_program_resource);
+    if(function == "glGetProgramResourceName") return proc(&get_program_resource_name);
+    if(function == "glGetProgramResourceIndex") return proc(&get_program_resource_index);
+    if(function == "glGetUniformLocation") return proc(&get_uniform_location);
+    if(function == "glFenceSync") return proc(&fence_sync);
+    if(function == "glClientWaitSync") return proc(&client_wait_sync);
+    if(function == "glGetSynciv") return proc(&get_sync);
+    if(function == "glMapBufferRange") return proc(&map_range);
+    if(function == "glMapNamedBufferRange") return proc(&map_named_range);
+    if(function == "glUnmapBuffer" || function == "glUnmapNamedBuffer") return proc(&unmap);
+    if(function == "glCheckFramebufferStatus") return proc(&framebuffer_status);
+    if(function == "glCheckNamedFramebufferStatus") return proc(&named_framebuffer_status);
+    if(function == "glGetQueryObjectuiv") return proc(&get_query_object);
+    if(function == "glGetTextureHandleARB") return proc(&get_texture_handle);
+    if(function == "glGetTextureSamplerHandleARB") return proc(&get_texture_sampler_handle);
+    return proc(&no_op);
+}
+
+}
+
+//true = success
+inline bool load_mock() {
+    return agl::init(&mock::load);
+}
+
+}
+
+#endif //AGL_GL_RECORDER_HPP
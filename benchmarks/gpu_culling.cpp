@@ -0,0 +1,206 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+//INSTANCES cubes scattered in front of the camera with a wall occluding the middle of the view, FRAMES frames:
+//CPU frustum culling writing indirect commands every frame versus agl::gpu_culler (frustum + Hi-Z occlusion
+//in compute, survivors drawn with multi-draw indirect count).
+//Times are CPU time spent in the calls (llvmpipe runs vertex and compute shading inside them) and per frame
+//including glFinish
+
+#include<cstdlib>
+#include<cmath>
+#include<random>
+#include<vector>
+
+#include "bench_util.hpp"
+
+constexpr int INSTANCES = 200000;
+constexpr int FRAMES = 10;
+constexpr int SIZE = 256;
+
+const char* VERTEX = R"(#version 450 core
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec4 sphere;
+uniform mat4 view_projection;
+void main() {
+    gl_Position = view_projection * vec4(position * sphere.w + sphere.xyz, 1);
+}
+)";
+const char* FRAGMENT = R"(#version 450 core
+out vec4 color;
+void main() {
+    color = vec4(1);
+}
+)";
+
+//Right handed, looking down -z from the origin
+static glm::mat4 perspective(float fov_y, float aspect, float near, float far) {
+    float focal = 1.0f / std::tan(fov_y * 0.5f);
+    glm::mat4 projection(0.0f);
+    projection[0][0] = focal / aspect;
+    projection[1][1] = focal;
+    projection[2][2] = (far + near) / (near - far);
+    projection[2][3] = -1.0f;
+    projection[3][2] = 2.0f * far * near / (near - far);
+    return projection;
+}
+
+int main() {
+    if(!agl_bench::create_headless_context()) {
+        return EXIT_FAILURE;
+    }
+    agl::program cubes;
+    if(!agl_bench::build_program(cubes, VERTEX, FRAGMENT)) {
+        return EXIT_FAILURE;
+    }
+    agl::gpu_culler culler(INSTANCES);
+    if(!culler.valid()) {
+        return EXIT_FAILURE;
+    }
+
+    //Unit cube (vertices 0-7) followed by the wall quad (vertices 8-11)
+    const float vertices[] = {
+        -1, -1, -1,  1, -1, -1,  1, 1, -1,  -1, 1, -1,
+        -1, -1,  1,  1, -1,  1,  1, 1,  1,  -1, 1,  1,
+        -1, -1,  0,  1, -1,  0,  1, 1,  0,  -1, 1,  0
+    };
+    const GLuint indices[] = {
+        0, 2, 1, 0, 3, 2,  4, 5, 6, 4, 6, 7,  0, 1, 5, 0, 5, 4,
+        3, 6, 2, 3, 7, 6,  0, 4, 7, 0, 7, 3,  1, 2, 6, 1, 6, 5,
+        8, 9, 10, 8, 10, 11
+    };
+    const agl::draw_elements_command cube{36, 1, 0, 0, 0};
+    const agl::draw_elements_command wall{6, 1, 36, 0, 0};
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> across(-150.0f, 150.0f);
+    std::uniform_real_distribution<float> height(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> depth(-300.0f, -25.0f);
+    std::vector<agl::cull_instance> instances(INSTANCES + 1);
+    for(int index = 0; index < INSTANCES; index++) {
+        instances[index] = {glm::vec4(across(random), height(random), depth(random), 0.5f), 0, {}};
+    }
+    //Wall 20 units away, 10 units square (about half the view's height)
+    instances[INSTANCES] = {glm::vec4(0.0f, 0.0f, -20.0f, 5.0f), 1, {}};
+    const agl::draw_elements_command meshes[] = {cube, wall};
+    culler.set_meshes(meshes);
+    culler.set_instances(std::span(instances).first(INSTANCES));
+
+    agl::buffer geometry;
+    geometry.storage(sizeof(vertices), vertices, 0);
+    agl::buffer elements;
+    elements.storage(sizeof(indices), indices, 0);
+    agl::buffer instance_data;
+    instance_data.storage(instances.size() * sizeof(agl::cull_instance), instances.data(), 0);
+    agl::vertex_array vao;
+    vao.enable_attrib(0);
+    vao.attrib_format(0, 3, GL_FLOAT, false, 0);
+    vao.attrib_binding(0, 0);
+    vao.vertex_buffer(0, geometry, 0, 3 * sizeof(float));
+    vao.enable_attrib(1);
+    vao.attrib_format(1, 4, GL_FLOAT, false, 0);
+    vao.attrib_binding(1, 1);
+    vao.vertex_buffer(1, instance_data, 0, sizeof(agl::cull_instance));
+    vao.binding_divisor(1, 1);
+    vao.element_buffer(elements);
+
+    agl::texture_2d color;
+    color.storage(1, GL_RGBA8, SIZE, SIZE);
+    agl::texture_2d depth_texture;
+    depth_texture.storage(1, GL_DEPTH_COMPONENT32F, SIZE, SIZE);
+    agl::framebuffer target;
+    target.attach(GL_COLOR_ATTACHMENT0, color);
+    target.attach(GL_DEPTH_ATTACHMENT, depth_texture);
+    target.bind();
+    glViewport(0, 0, SIZE, SIZE);
+    glEnable(GL_DEPTH_TEST);
+
+    glm::mat4 view_projection = perspective(1.0f, 1.0f, 0.5f, 500.0f);
+    cubes.bind();
+    agl::program::bound::set_uniform(cubes.uniform_location("view_projection"), view_projection);
+
+    //Occluder prepass, the wall is the last instance
+    auto draw_wall = [&] {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        cubes.bind();
+        vao.bind();
+        glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, 6, GL_UNSIGNED_INT,
+            reinterpret_cast<void*>(36 * sizeof(GLuint)), 1, 0, INSTANCES);
+    };
+
+    //CPU: sphere against the planes of the view projection's rows
+    glm::vec4 planes[6];
+    for(int axis = 0; axis < 3; axis++) {
+        for(int side = 0; side < 2; side++) {
+            glm::vec4& plane = planes[axis * 2 + side];
+            float sign = side == 0 ? 1.0f : -1.0f;
+            for(int column = 0; column < 4; column++) {
+                plane[column] = view_projection[column][3] + sign * view_projection[column][axis];
+            }
+        }
+    }
+    agl::buffer cpu_commands;
+    cpu_commands.storage(INSTANCES * sizeof(agl::draw_elements_command), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    std::vector<agl::draw_elements_command> visible_commands;
+    visible_commands.reserve(INSTANCES);
+
+    double cpu_thread = 0.0;
+    double cpu_cull = 0.0;
+    auto start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        draw_wall();
+        auto submit = agl_bench::clock::now();
+        visible_commands.clear();
+        for(int index = 0; index < INSTANCES; index++) {
+            glm::vec4 sphere = instances[index].sphere;
+            bool visible = true;
+            for(glm::vec4 const& plane : planes) {
+                float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+                if(plane.x * sphere.x + plane.y * sphere.y + plane.z * sphere.z + plane.w < -sphere.w * length) {
+                    visible = false;
+                    break;
+                }
+            }
+            if(visible) {
+                visible_commands.push_back({cube.count, 1, cube.first_index, cube.base_vertex, static_cast<GLuint>(index)});
+            }
+        }
+        cpu_commands.sub_data(0, visible_commands.size() * sizeof(agl::draw_elements_command), visible_commands.data());
+        cpu_cull += agl_bench::seconds_since(submit);
+        cpu_commands.bind(GL_DRAW_INDIRECT_BUFFER);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(visible_commands.size()), 0);
+        cpu_thread += agl_bench::seconds_since(submit);
+    }
+    glFinish();
+    double cpu_frames = agl_bench::seconds_since(start);
+
+    double gpu_thread = 0.0;
+    double gpu_cull = 0.0;
+    start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        draw_wall();
+        auto submit = agl_bench::clock::now();
+        culler.build_hi_z(depth_texture, SIZE, SIZE);
+        culler.cull(view_projection);
+        gpu_cull += agl_bench::seconds_since(submit);
+        cubes.bind();
+        vao.bind();
+        culler.draw(GL_TRIANGLES, GL_UNSIGNED_INT);
+        gpu_thread += agl_bench::seconds_since(submit);
+    }
+    glFinish();
+    double gpu_frames = agl_bench::seconds_since(start);
+    GLuint occlusion_visible = culler.read_visible_count();
+
+    culler.clear_hi_z();
+    culler.cull(view_projection);
+    GLuint frustum_visible = culler.read_visible_count();
+
+    std::cout << INSTANCES << " instances, " << FRAMES << " frames at " << SIZE << "x" << SIZE
+              << (agl::indirect_parameters() ? "" : " (no indirect count, commands not compacted)") << std::endl;
+    std::cout << "CPU frustum culling: " << cpu_cull * 1e3 / FRAMES << " ms/frame culling, " << cpu_thread * 1e3 / FRAMES << " ms/frame culling + drawing, "
+              << cpu_frames * 1e3 / FRAMES << " ms/frame total, " << visible_commands.size() << " drawn" << std::endl;
+    std::cout << "gpu_culler:          " << gpu_cull * 1e3 / FRAMES << " ms/frame culling, " << gpu_thread * 1e3 / FRAMES << " ms/frame culling + drawing, "
+              << gpu_frames * 1e3 / FRAMES << " ms/frame total, " << occlusion_visible << " drawn ("
+              << frustum_visible << " inside the frustum)" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,76 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+//A PASSES pass post-processing chain per frame: every pass allocating its own texture and framebuffer
+//versus targets from agl::render_target_pool (ping-ponging through release)
+
+#include<cstdlib>
+#include<vector>
+
+#include "bench_util.hpp"
+
+constexpr int FRAMES = 200;
+constexpr int PASSES = 6;
+constexpr GLsizei WIDTH = 1280;
+constexpr GLsizei HEIGHT = 720;
+
+//Stand-in for a fullscreen pass reading the previous pass's output
+static void run_pass(int pass) {
+    glClearColor(pass / float(PASSES), 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+int main() {
+    if(!agl_bench::create_headless_context()) {
+        return EXIT_FAILURE;
+    }
+
+    auto start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        std::vector<agl::texture_2d> textures;
+        std::vector<agl::render_target> targets;
+        textures.reserve(PASSES);
+        for(int pass = 0; pass < PASSES; pass++) {
+            agl::texture_2d& color = textures.emplace_back();
+            color.storage(1, GL_RGBA16F, WIDTH, HEIGHT);
+            targets.push_back(agl::framebuffer_builder().color(0, color).build());
+            targets.back().bind();
+            run_pass(pass);
+        }
+        glFinish();
+    }
+    double allocating_seconds = agl_bench::seconds_since(start);
+
+    agl::render_target_pool pool;
+    const agl::transient_attachment attachments[] = {
+        {GL_COLOR_ATTACHMENT0, GL_RGBA16F}
+    };
+    start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        agl::render_target* previous = nullptr;
+        for(int pass = 0; pass < PASSES; pass++) {
+            agl::render_target& target = pool.acquire(WIDTH, HEIGHT, 0, attachments);
+            if(!target.complete()) {
+                return EXIT_FAILURE;
+            }
+            target.bind();
+            run_pass(pass);
+            //The pass that read previous was issued, its texture can be reused
+            if(previous != nullptr) {
+                pool.release(*previous);
+            }
+            previous = &target;
+        }
+        pool.end_frame();
+        glFinish();
+    }
+    double pooled_seconds = agl_bench::seconds_since(start);
+    agl::render_target_pool::statistics stats = pool.stats();
+
+    std::cout << FRAMES << " frames, " << PASSES << " passes of " << WIDTH << "x" << HEIGHT << " RGBA16F" << std::endl;
+    std::cout << "Allocating per pass: " << allocating_seconds * 1e3 / FRAMES << " ms/frame, "
+              << FRAMES * PASSES << " texture allocations" << std::endl;
+    std::cout << "render_target_pool:  " << pooled_seconds * 1e3 / FRAMES << " ms/frame, "
+              << stats.texture_allocations << " texture allocations, " << stats.target_builds << " framebuffers built, "
+              << stats.textures << " textures pooled" << std::endl;
+    return EXIT_SUCCESS;
+}
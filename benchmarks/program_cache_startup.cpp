@@ -0,0 +1,105 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+//Startup link time of PROGRAMS shader variants compiled from GLSL (cold) versus restored from
+//an agl::program_cache archive (warm), usage: program_cache_startup [archive path]
+
+#include<cstdlib>
+#include<string>
+#include<vector>
+#include<filesystem>
+
+#include "bench_util.hpp"
+
+constexpr int PROGRAMS = 64;
+
+const char* VERTEX = R"(#version 450 core
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+uniform mat4 model;
+uniform mat4 view_projection;
+out vec3 world_normal;
+void main() {
+    world_normal = mat3(model) * normal;
+    gl_Position = view_projection * model * vec4(position * float(VARIANT + 1), 1);
+}
+)";
+const char* FRAGMENT = R"(#version 450 core
+in vec3 world_normal;
+uniform vec3 light_direction;
+uniform vec4 color;
+out vec4 result;
+void main() {
+    float light = max(dot(normalize(world_normal), light_direction), 0.0);
+    for(int i = 0; i < VARIANT % 8; i++) {
+        light = light * 0.9 + 0.05 * sin(light * float(i));
+    }
+    result = color * light;
+}
+)";
+
+//Links every variant through the cache, returns seconds or a negative value on failure
+static double link_all(agl::program_cache& cache, std::vector<std::string> const& defines) {
+    const agl::shader_source sources[] = {
+        {GL_VERTEX_SHADER, VERTEX},
+        {GL_FRAGMENT_SHADER, FRAGMENT}
+    };
+    std::vector<agl::program> programs(defines.size());
+    auto start = agl_bench::clock::now();
+    for(size_t index = 0; index < defines.size(); index++) {
+        if(!cache.link(programs[index], sources, defines[index])) {
+            std::cerr << programs[index].info_log() << std::endl;
+            return -1.0;
+        }
+    }
+    glFinish();
+    return agl_bench::seconds_since(start);
+}
+
+int main(int argc, char** argv) {
+    //Keep Mesa's own on-disk shader cache from turning the cold run warm
+    //Mesa only exposes program binaries with its own shader disk cache enabled, give it an empty
+    //directory so that cache cannot turn the cold run warm
+    std::filesystem::path mesa_cache = std::filesystem::temp_directory_path() / "agl_program_cache_mesa";
+    std::filesystem::remove_all(mesa_cache);
+    setenv("MESA_SHADER_CACHE_DIR", mesa_cache.string().c_str(), 1);
+    if(!agl_bench::create_headless_context()) {
+        return EXIT_FAILURE;
+    }
+
+    std::filesystem::path path = argc > 1
+        ? std::filesystem::path(argv[1])
+        : std::filesystem::temp_directory_path() / "agl_program_cache.bin";
+    std::filesystem::remove(path);
+
+    std::vector<std::string> defines;
+    for(int variant = 0; variant < PROGRAMS; variant++) {
+        defines.push_back("#define VARIANT " + std::to_string(variant) + "\n");
+    }
+
+    double cold_seconds;
+    {
+        agl::program_cache cache(path.string());
+        if(!cache.binaries_supported()) {
+            std::cerr << "Driver exposes no program binary formats, nothing to measure" << std::endl;
+            return EXIT_FAILURE;
+        }
+        cold_seconds = link_all(cache, defines);
+        if(cold_seconds < 0.0 || !cache.save()) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    agl::program_cache cache(path.string());
+    double warm_seconds = link_all(cache, defines);
+    if(warm_seconds < 0.0) {
+        return EXIT_FAILURE;
+    }
+    agl::program_cache::statistics stats = cache.stats();
+
+    std::cout << "Archive: " << path.string() << " (" << std::filesystem::file_size(path) << " bytes, "
+              << cache.entry_count() << " programs)" << std::endl;
+    std::cout << "Cold (GLSL):   " << cold_seconds * 1e3 << " ms, " << cold_seconds * 1e3 / PROGRAMS << " ms/program" << std::endl;
+    std::cout << "Warm (binary): " << warm_seconds * 1e3 << " ms, " << warm_seconds * 1e3 / PROGRAMS << " ms/program" << std::endl;
+    std::cout << "Warm hits " << stats.hits << ", misses " << stats.misses << ", rejected " << stats.rejected << std::endl;
+    return EXIT_SUCCESS;
+}
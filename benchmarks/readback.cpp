@@ -0,0 +1,94 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+//Per-frame cost of reading back a WIDTHxHEIGHT RGBA8 frame: synchronous glReadPixels into client memory
+//versus agl::readback_queue, every read frame is checked against the color it was cleared to
+
+#include<cstdlib>
+#include<cstdint>
+#include<vector>
+#include<algorithm>
+
+#include "bench_util.hpp"
+
+constexpr int FRAMES = 240;
+constexpr GLsizei WIDTH = 1920;
+constexpr GLsizei HEIGHT = 1080;
+
+static std::uint8_t frame_shade(std::uint64_t frame) {
+    return static_cast<std::uint8_t>(frame * 7 % 251);
+}
+static void render(agl::framebuffer& target, std::uint64_t frame) {
+    target.bind();
+    float shade = frame_shade(frame) / 255.0f;
+    glClearColor(shade, 1.0f - shade, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+static bool check(const std::byte* pixels, std::uint64_t frame) {
+    return std::abs(int(std::to_integer<std::uint8_t>(pixels[0])) - int(frame_shade(frame))) <= 1;
+}
+
+int main() {
+    if(!agl_bench::create_headless_context()) {
+        return EXIT_FAILURE;
+    }
+
+    agl::texture_2d color;
+    color.storage(1, GL_RGBA8, WIDTH, HEIGHT);
+    agl::framebuffer target;
+    glNamedFramebufferTexture(target.id(), GL_COLOR_ATTACHMENT0, color.id(), 0);
+
+    const double megabytes = double(WIDTH) * HEIGHT * 4 * FRAMES / (1024.0 * 1024.0);
+
+    std::vector<std::byte> client(size_t(WIDTH) * HEIGHT * 4);
+    double sync_worst = 0.0;
+    auto start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        auto frame_start = agl_bench::clock::now();
+        render(target, frame);
+        target.bind_read();
+        glReadPixels(0, 0, WIDTH, HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, client.data());
+        if(!check(client.data(), frame)) {
+            std::cerr << "Error: Synchronous readback of frame " << frame << " is wrong!" << std::endl;
+            return EXIT_FAILURE;
+        }
+        sync_worst = std::max(sync_worst, agl_bench::seconds_since(frame_start));
+    }
+    double sync_seconds = agl_bench::seconds_since(start);
+
+    agl::readback_queue queue(GLsizeiptr(WIDTH) * HEIGHT * 4, 3);
+    double async_worst = 0.0;
+    auto consume = [&](agl::readback_queue::frame const& done) {
+        if(!check(done.pixels.data(), done.sequence)) {
+            std::cerr << "Error: Readback of frame " << done.sequence << " is wrong!" << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        queue.release(done);
+    };
+    start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        auto frame_start = agl_bench::clock::now();
+        render(target, frame);
+        //Keeps the queue from dropping frames, an encoder would consume as fast as it can
+        if(queue.pending() == 3) {
+            consume(*queue.wait());
+        }
+        queue.request(target, 0, 0, WIDTH, HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE);
+        while(auto done = queue.poll()) {
+            consume(*done);
+        }
+        async_worst = std::max(async_worst, agl_bench::seconds_since(frame_start));
+    }
+    while(auto done = queue.wait()) {
+        consume(*done);
+    }
+    double async_seconds = agl_bench::seconds_since(start);
+    agl::readback_queue::statistics stats = queue.stats();
+
+    std::cout << FRAMES << " frames of " << WIDTH << "x" << HEIGHT << " RGBA8" << std::endl;
+    std::cout << "glReadPixels:   " << sync_seconds * 1e3 / FRAMES << " ms/frame (worst " << sync_worst * 1e3 << " ms), "
+              << megabytes / sync_seconds << " MB/s" << std::endl;
+    std::cout << "readback_queue: " << async_seconds * 1e3 / FRAMES << " ms/frame (worst " << async_worst * 1e3 << " ms), "
+              << stats.megabytes_per_second() << " MB/s, latency avg " << stats.average_latency() * 1e3 << " ms / max "
+              << stats.max_latency * 1e3 << " ms, dropped " << stats.dropped << std::endl;
+    return EXIT_SUCCESS;
+}
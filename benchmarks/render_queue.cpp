@@ -0,0 +1,143 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+//DRAWS draws per frame over a mix of programs, vertex arrays and materials in scene order:
+//issued as submitted (binds cached) versus recorded into agl::render_queue and replayed in sort key order
+
+#include<cstdlib>
+#include<random>
+#include<string>
+#include<vector>
+
+#include "bench_util.hpp"
+
+constexpr int FRAMES = 20;
+constexpr int DRAWS = 50000;
+constexpr int PROGRAMS = 6;
+constexpr int MESHES = 12;
+constexpr int MATERIALS = 16;
+constexpr GLuint TRIANGLES_PER_MESH = 64;
+
+const char* VERTEX = R"(#version 450 core
+layout(location = 0) in vec2 position;
+void main() {
+    gl_Position = vec4(position * SCALE, 0, 1);
+}
+)";
+const char* FRAGMENT = R"(#version 450 core
+layout(binding = 0) uniform sampler2D albedo;
+layout(binding = 1) uniform sampler2D normal;
+out vec4 result;
+void main() {
+    result = texture(albedo, vec2(0.5)) + texture(normal, vec2(0.5));
+}
+)";
+
+struct scene_draw {
+    int program;
+    int mesh;
+    int material;
+    float depth;
+    GLuint first;
+};
+
+int main() {
+    if(!agl_bench::create_headless_context()) {
+        return EXIT_FAILURE;
+    }
+
+    std::vector<agl::program> programs(PROGRAMS);
+    for(int index = 0; index < PROGRAMS; index++) {
+        //Distinct programs with the same interface
+        std::string defines = "#define SCALE " + std::to_string(1.0f / (index + 1)) + "\n";
+        if(!agl_bench::build_program(programs[index], VERTEX, FRAGMENT, defines)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+    std::vector<float> vertices(TRIANGLES_PER_MESH * 3 * 2);
+    std::vector<GLuint> indices(TRIANGLES_PER_MESH * 3);
+    for(GLuint index = 0; index < indices.size(); index++) {
+        indices[index] = index;
+    }
+
+    std::vector<agl::buffer> vertex_buffers(MESHES);
+    std::vector<agl::buffer> index_buffers(MESHES);
+    std::vector<agl::vertex_array> meshes(MESHES);
+    for(int mesh = 0; mesh < MESHES; mesh++) {
+        for(float& value : vertices) {
+            value = coordinate(random);
+        }
+        vertex_buffers[mesh].storage(vertices.size() * sizeof(float), vertices.data(), 0);
+        index_buffers[mesh].storage(indices.size() * sizeof(GLuint), indices.data(), 0);
+        meshes[mesh].enable_attrib(0);
+        meshes[mesh].attrib_format(0, 2, GL_FLOAT, false, 0);
+        meshes[mesh].attrib_binding(0, 0);
+        meshes[mesh].vertex_buffer(0, vertex_buffers[mesh], 0, 2 * sizeof(float));
+        meshes[mesh].element_buffer(index_buffers[mesh]);
+    }
+
+    //Each material binds an albedo and a normal map
+    std::vector<agl::texture_2d> textures(MATERIALS * 2);
+    std::vector<std::vector<agl::any_texture*>> materials(MATERIALS);
+    for(int material = 0; material < MATERIALS; material++) {
+        for(int unit = 0; unit < 2; unit++) {
+            agl::texture_2d& texture = textures[material * 2 + unit];
+            texture.storage(1, GL_RGBA8, 4, 4);
+            materials[material].push_back(&texture);
+        }
+    }
+
+    std::uniform_int_distribution<int> pick_program(0, PROGRAMS - 1);
+    std::uniform_int_distribution<int> pick_mesh(0, MESHES - 1);
+    std::uniform_int_distribution<int> pick_material(0, MATERIALS - 1);
+    std::uniform_real_distribution<float> pick_depth(0.0f, 1.0f);
+    std::uniform_int_distribution<GLuint> pick_triangle(0, TRIANGLES_PER_MESH - 1);
+    std::vector<scene_draw> scene(DRAWS);
+    for(scene_draw& draw : scene) {
+        draw = {pick_program(random), pick_mesh(random), pick_material(random), pick_depth(random), pick_triangle(random) * 3};
+    }
+
+    glEnable(GL_RASTERIZER_DISCARD);
+
+    auto start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        for(scene_draw const& draw : scene) {
+            programs[draw.program].bind();
+            meshes[draw.mesh].bind();
+            for(size_t unit = 0; unit < materials[draw.material].size(); unit++) {
+                materials[draw.material][unit]->bind(static_cast<GLuint>(unit));
+            }
+            glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, 3, GL_UNSIGNED_INT,
+                reinterpret_cast<const void*>(draw.first * sizeof(GLuint)), 1, 0, 0);
+        }
+        glFinish();
+    }
+    double submitted_seconds = agl_bench::seconds_since(start);
+
+    agl::render_queue queue;
+    start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        for(scene_draw const& draw : scene) {
+            agl::render_command command{
+                &programs[draw.program], &meshes[draw.mesh], materials[draw.material],
+                GL_TRIANGLES, GL_UNSIGNED_INT, 3, draw.first
+            };
+            queue.submit(0, draw.material, draw.depth, command);
+        }
+        queue.flush();
+        glFinish();
+    }
+    double queued_seconds = agl_bench::seconds_since(start);
+    agl::render_queue::statistics stats = queue.stats();
+
+    std::cout << FRAMES << " frames of " << DRAWS << " draws (" << PROGRAMS << " programs, " << MESHES
+              << " vertex arrays, " << MATERIALS << " two-texture materials)" << std::endl;
+    std::cout << "Submission order: " << submitted_seconds * 1e3 / FRAMES << " ms/frame, "
+              << stats.submission_order_state_changes / FRAMES << " state changes per frame" << std::endl;
+    std::cout << "render_queue:     " << queued_seconds * 1e3 / FRAMES << " ms/frame, "
+              << stats.state_changes / FRAMES << " state changes per frame, "
+              << stats.avoided_state_changes() / FRAMES << " avoided" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,74 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+//Compares per-frame upload throughput of glBufferSubData against agl::streaming_buffer,
+//every chunk is consumed on the GPU (copied into a sink buffer) so neither path can skip the transfer
+
+#include<vector>
+#include<cstdlib>
+
+#include "bench_util.hpp"
+
+constexpr GLsizeiptr CHUNK_SIZE = 64 * 1024;
+constexpr GLsizeiptr CHUNKS_PER_FRAME = 64;
+constexpr GLsizeiptr FRAME_SIZE = CHUNK_SIZE * CHUNKS_PER_FRAME;
+constexpr int FRAMES = 240;
+
+double bench_buffer_sub_data(std::vector<std::byte> const& data) {
+    agl::buffer source;
+    agl::buffer sink;
+    source.bind(GL_COPY_READ_BUFFER);
+    glBufferData(GL_COPY_READ_BUFFER, FRAME_SIZE, nullptr, GL_STREAM_DRAW);
+    sink.bind(GL_COPY_WRITE_BUFFER);
+    glBufferData(GL_COPY_WRITE_BUFFER, FRAME_SIZE, nullptr, GL_STATIC_DRAW);
+    glFinish();
+
+    auto start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        for(GLsizeiptr chunk = 0; chunk < CHUNKS_PER_FRAME; chunk++) {
+            glBufferSubData(GL_COPY_READ_BUFFER, chunk * CHUNK_SIZE, CHUNK_SIZE, data.data() + chunk * CHUNK_SIZE);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, chunk * CHUNK_SIZE, chunk * CHUNK_SIZE, CHUNK_SIZE);
+        }
+    }
+    glFinish();
+    return agl_bench::seconds_since(start);
+}
+
+double bench_streaming_buffer(std::vector<std::byte> const& data) {
+    agl::streaming_buffer source(FRAME_SIZE);
+    agl::buffer sink;
+    sink.bind(GL_COPY_WRITE_BUFFER);
+    glBufferData(GL_COPY_WRITE_BUFFER, FRAME_SIZE, nullptr, GL_STATIC_DRAW);
+    source.bind(GL_COPY_READ_BUFFER);
+    glFinish();
+
+    auto start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        for(GLsizeiptr chunk = 0; chunk < CHUNKS_PER_FRAME; chunk++) {
+            auto alloc = source.push(data.data() + chunk * CHUNK_SIZE, CHUNK_SIZE);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, alloc.offset, chunk * CHUNK_SIZE, CHUNK_SIZE);
+        }
+        source.next_frame();
+    }
+    glFinish();
+    return agl_bench::seconds_since(start);
+}
+
+int main() {
+    if(!agl_bench::create_headless_context()) {
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::byte> data(FRAME_SIZE);
+    for(size_t index = 0; index < data.size(); index++) {
+        data[index] = static_cast<std::byte>(index * 31);
+    }
+
+    double total_mb = double(FRAME_SIZE) * FRAMES / (1024.0 * 1024.0);
+    double sub_data_seconds = bench_buffer_sub_data(data);
+    double streaming_seconds = bench_streaming_buffer(data);
+
+    std::cout << "Uploaded " << total_mb << " MB over " << FRAMES << " frames per path" << std::endl;
+    std::cout << "glBufferSubData:       " << total_mb / sub_data_seconds << " MB/s" << std::endl;
+    std::cout << "agl::streaming_buffer: " << total_mb / streaming_seconds << " MB/s" << std::endl;
+    return EXIT_SUCCESS;
+}
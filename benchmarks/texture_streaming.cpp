@@ -0,0 +1,93 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+//Frame times while streaming TEXTURES mipmapped RGBA8 textures: created and uploaded on the render thread
+//(one per frame) versus on agl::resource_loader workers and published per frame
+
+#include<cstdlib>
+#include<cstdint>
+#include<vector>
+#include<algorithm>
+#include<thread>
+
+#include "bench_util.hpp"
+
+constexpr int TEXTURES = 32;
+constexpr GLsizei SIZE = 1024;
+
+struct frame_stats {
+    int frames = 0;
+    double worst = 0.0;
+    double total = 0.0;
+};
+
+//Stand-in for the frame's own work
+static void render_frame() {
+    glFinish();
+    std::this_thread::sleep_for(std::chrono::milliseconds(4));
+}
+
+static agl::texture_2d create_texture(std::vector<std::uint32_t> const& pixels) {
+    agl::texture_2d texture;
+    texture.storage(11, GL_RGBA8, SIZE, SIZE);
+    texture.sub_image(0, 0, 0, SIZE, SIZE, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    texture.generate_mipmap();
+    return texture;
+}
+
+int main() {
+    if(!agl_bench::create_headless_context()) {
+        return EXIT_FAILURE;
+    }
+    std::vector<std::uint32_t> pixels(SIZE * SIZE);
+    for(size_t index = 0; index < pixels.size(); index++) {
+        pixels[index] = static_cast<std::uint32_t>(index * 2654435761u);
+    }
+
+    frame_stats render_thread;
+    {
+        std::vector<agl::texture_2d> textures;
+        auto start = agl_bench::clock::now();
+        while(textures.size() < TEXTURES) {
+            auto frame_start = agl_bench::clock::now();
+            textures.push_back(create_texture(pixels));
+            render_frame();
+            render_thread.worst = std::max(render_thread.worst, agl_bench::seconds_since(frame_start));
+            render_thread.frames++;
+        }
+        render_thread.total = agl_bench::seconds_since(start);
+    }
+
+    frame_stats loader_thread;
+    size_t workers;
+    {
+        agl::resource_loader loader(2);
+        workers = loader.worker_count();
+        std::vector<agl::resource_future<agl::texture_2d>> textures;
+        auto start = agl_bench::clock::now();
+        for(int index = 0; index < TEXTURES; index++) {
+            textures.push_back(loader.submit([&pixels]() {return create_texture(pixels);}));
+        }
+        while(loader.pending() > 0) {
+            auto frame_start = agl_bench::clock::now();
+            loader.publish();
+            render_frame();
+            loader_thread.worst = std::max(loader_thread.worst, agl_bench::seconds_since(frame_start));
+            loader_thread.frames++;
+        }
+        loader_thread.total = agl_bench::seconds_since(start);
+
+        for(auto& texture : textures) {
+            if(!texture.ready() || texture.get().id() == 0) {
+                std::cerr << "Error: Texture was not published!" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    std::cout << TEXTURES << " textures of " << SIZE << "x" << SIZE << " RGBA8 with mipmaps" << std::endl;
+    std::cout << "Render thread:       " << render_thread.total * 1e3 << " ms, " << render_thread.frames
+              << " frames, worst frame " << render_thread.worst * 1e3 << " ms" << std::endl;
+    std::cout << "resource_loader (" << workers << "): " << loader_thread.total * 1e3 << " ms, " << loader_thread.frames
+              << " frames, worst frame " << loader_thread.worst * 1e3 << " ms" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,153 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+//QUADS quads each sampling one of MATERIALS textures, FRAMES frames: a texture bind and draw per quad versus one
+//instanced draw indexing an agl::texture_table (bindless handles with ARB_bindless_texture, a texture array otherwise).
+//Times are CPU time spent submitting and per frame including glFinish, the two images are compared
+
+#include<cstdlib>
+#include<vector>
+
+#include "bench_util.hpp"
+
+constexpr int MATERIALS = 256;
+constexpr int QUADS = 16384;
+constexpr int FRAMES = 10;
+constexpr int TEXTURE_SIZE = 16;
+constexpr int SIZE = 256;
+
+//Quads on a 128 x 128 grid covering the target
+const char* VERTEX = R"(#version 450 core
+layout(location = 0) in uvec2 quad;
+out vec2 uv;
+flat out uint table_index;
+void main() {
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    vec2 cell = vec2(quad.y % 128, quad.y / 128);
+    uv = corner;
+    table_index = quad.x;
+    gl_Position = vec4((cell + corner) / 64.0 - 1.0, 0, 1);
+}
+)";
+const char* SEPARATE_FRAGMENT = R"(#version 450 core
+in vec2 uv;
+flat in uint table_index;
+layout(binding = 0) uniform sampler2D material_texture;
+out vec4 color;
+void main() {
+    color = texture(material_texture, uv);
+}
+)";
+const char* TABLE_FRAGMENT = R"(#version 450 core
+#ifdef AGL_TEXTURE_TABLE_BINDLESS
+#extension GL_ARB_bindless_texture : require
+layout(std430, binding = 0) readonly buffer texture_table {uvec2 handles[];};
+vec4 table_texture(uint index, vec2 uv) {return texture(sampler2D(handles[index]), uv);}
+#else
+layout(binding = 0) uniform sampler2DArray texture_table;
+vec4 table_texture(uint index, vec2 uv) {return texture(texture_table, vec3(uv, index));}
+#endif
+in vec2 uv;
+flat in uint table_index;
+out vec4 color;
+void main() {
+    color = table_texture(table_index, uv);
+}
+)";
+
+int main() {
+    if(!agl_bench::create_headless_context()) {
+        return EXIT_FAILURE;
+    }
+
+    std::vector<agl::texture_2d> textures(MATERIALS);
+    std::vector<GLuint> texels(TEXTURE_SIZE * TEXTURE_SIZE);
+    for(int material = 0; material < MATERIALS; material++) {
+        std::fill(texels.begin(), texels.end(), 0xff000000u | (material * 0x9e3779u & 0xffffffu));
+        textures[material].storage(1, GL_RGBA8, TEXTURE_SIZE, TEXTURE_SIZE);
+        textures[material].sub_image(0, 0, 0, TEXTURE_SIZE, TEXTURE_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+        textures[material].parameter(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    }
+    agl::texture_table table(MATERIALS, MATERIALS, GL_RGBA8, TEXTURE_SIZE, TEXTURE_SIZE);
+    for(agl::texture_2d& texture : textures) {
+        table.add(texture);
+    }
+
+    agl::program separate;
+    agl::program indexed;
+    if(!agl_bench::build_program(separate, VERTEX, SEPARATE_FRAGMENT)
+        || !agl_bench::build_program(indexed, VERTEX, TABLE_FRAGMENT, table.defines())) {
+        return EXIT_FAILURE;
+    }
+
+    //Per quad material and grid cell, materials scattered so neighbouring quads never share one
+    std::vector<GLuint> quads(QUADS * 2);
+    for(int quad = 0; quad < QUADS; quad++) {
+        quads[quad * 2] = static_cast<GLuint>(quad * 97 % MATERIALS);
+        quads[quad * 2 + 1] = static_cast<GLuint>(quad);
+    }
+    agl::buffer quad_data;
+    quad_data.storage(quads.size() * sizeof(GLuint), quads.data(), 0);
+    agl::vertex_array vao;
+    vao.enable_attrib(0);
+    vao.attrib_i_format(0, 2, GL_UNSIGNED_INT, 0);
+    vao.attrib_binding(0, 0);
+    vao.vertex_buffer(0, quad_data, 0, 2 * sizeof(GLuint));
+    vao.binding_divisor(0, 1);
+
+    agl::texture_2d color;
+    color.storage(1, GL_RGBA8, SIZE, SIZE);
+    agl::framebuffer target;
+    target.attach(GL_COLOR_ATTACHMENT0, color);
+    target.bind();
+    glViewport(0, 0, SIZE, SIZE);
+    std::vector<GLuint> separate_image(SIZE * SIZE);
+    std::vector<GLuint> indexed_image(SIZE * SIZE);
+
+    double separate_thread = 0.0;
+    auto start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        glClear(GL_COLOR_BUFFER_BIT);
+        auto submit = agl_bench::clock::now();
+        separate.bind();
+        vao.bind();
+        for(int quad = 0; quad < QUADS; quad++) {
+            textures[quads[quad * 2]].bind(0);
+            glDrawArraysInstancedBaseInstance(GL_TRIANGLE_STRIP, 0, 4, 1, quad);
+        }
+        separate_thread += agl_bench::seconds_since(submit);
+    }
+    glFinish();
+    double separate_frames = agl_bench::seconds_since(start);
+    glReadPixels(0, 0, SIZE, SIZE, GL_RGBA, GL_UNSIGNED_BYTE, separate_image.data());
+
+    double indexed_thread = 0.0;
+    start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        glClear(GL_COLOR_BUFFER_BIT);
+        auto submit = agl_bench::clock::now();
+        for(int material = 0; material < MATERIALS; material++) {
+            table.use(material);
+        }
+        table.bind(0, 0);
+        indexed.bind();
+        vao.bind();
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, QUADS);
+        table.end_frame();
+        indexed_thread += agl_bench::seconds_since(submit);
+    }
+    glFinish();
+    double indexed_frames = agl_bench::seconds_since(start);
+    glReadPixels(0, 0, SIZE, SIZE, GL_RGBA, GL_UNSIGNED_BYTE, indexed_image.data());
+
+    std::cout << QUADS << " quads, " << MATERIALS << " materials, " << FRAMES << " frames at " << SIZE << "x" << SIZE
+              << (table.bindless() ? " (bindless handles)" : " (no ARB_bindless_texture, texture array fallback)") << std::endl;
+    std::cout << "bind + draw per quad: " << separate_thread * 1e3 / FRAMES << " ms/frame submitting, "
+              << separate_frames * 1e3 / FRAMES << " ms/frame total" << std::endl;
+    std::cout << "texture_table:        " << indexed_thread * 1e3 / FRAMES << " ms/frame submitting, "
+              << indexed_frames * 1e3 / FRAMES << " ms/frame total, " << table.stats().resident << " resident" << std::endl;
+    if(separate_image != indexed_image) {
+        std::cerr << "Error: texture_table image differs from the separate draws!" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,85 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+//Render thread time spent uploading TEXTURES mipmapped RGBA8 textures (every level its own upload):
+//sub_image from client memory versus agl::texture_upload_pool staging buffers, TEXTURES_PER_FRAME per frame
+
+#include<cstdlib>
+#include<cstdint>
+#include<vector>
+#include<span>
+
+#include "bench_util.hpp"
+
+constexpr int TEXTURES = 64;
+constexpr int TEXTURES_PER_FRAME = 4;
+constexpr GLsizei SIZE = 512;
+constexpr GLsizei LEVELS = 10;
+
+int main() {
+    if(!agl_bench::create_headless_context()) {
+        return EXIT_FAILURE;
+    }
+
+    //Every level of the chain back to back
+    std::vector<std::byte> pixels;
+    for(GLsizei level = 0, size = SIZE; level < LEVELS; level++, size /= 2) {
+        for(GLsizei index = 0; index < size * size * 4; index++) {
+            pixels.push_back(static_cast<std::byte>(index * 31 + level));
+        }
+    }
+    auto upload_all = [&](auto&& upload_level) {
+        std::vector<agl::texture_2d> textures(TEXTURES);
+        double upload_seconds = 0.0;
+        auto start = agl_bench::clock::now();
+        for(int index = 0; index < TEXTURES; index++) {
+            textures[index].storage(LEVELS, GL_RGBA8, SIZE, SIZE);
+            auto upload_start = agl_bench::clock::now();
+            size_t offset = 0;
+            for(GLsizei level = 0, size = SIZE; level < LEVELS; level++, size /= 2) {
+                size_t bytes = size_t(size) * size * 4;
+                upload_level(textures[index], level, size, std::span<const std::byte>(pixels).subspan(offset, bytes));
+                offset += bytes;
+            }
+            upload_seconds += agl_bench::seconds_since(upload_start);
+            if(index % TEXTURES_PER_FRAME == TEXTURES_PER_FRAME - 1) {
+                upload_level.end_frame();
+            }
+        }
+        glFinish();
+        return std::pair{upload_seconds, agl_bench::seconds_since(start)};
+    };
+
+    struct direct_upload {
+        void operator()(agl::texture_2d& tex, GLint level, GLsizei size, std::span<const std::byte> data) {
+            tex.sub_image(level, 0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
+        }
+        void end_frame() {
+            glFlush();
+        }
+    };
+    auto [direct_upload_seconds, direct_total] = upload_all(direct_upload{});
+
+    agl::texture_upload_pool pool(8 << 20, 3);
+    struct pooled_upload {
+        agl::texture_upload_pool& pool;
+        void operator()(agl::texture_2d& tex, GLint level, GLsizei size, std::span<const std::byte> data) {
+            pool.upload(tex, level, 0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, data);
+        }
+        void end_frame() {
+            pool.flush();
+        }
+    };
+    auto [pool_upload_seconds, pool_total] = upload_all(pooled_upload{pool});
+    pool.flush();
+    agl::texture_upload_pool::statistics stats = pool.stats();
+
+    double megabytes = double(pixels.size()) * TEXTURES / (1 << 20);
+    std::cout << TEXTURES << " textures, " << megabytes << " MiB in " << TEXTURES * LEVELS << " level uploads" << std::endl;
+    std::cout << "Client memory: " << direct_upload_seconds * 1e3 << " ms in upload calls ("
+              << megabytes / direct_upload_seconds << " MiB/s), " << direct_total * 1e3 << " ms until complete" << std::endl;
+    std::cout << "Upload pool:   " << pool_upload_seconds * 1e3 << " ms in upload calls ("
+              << stats.throughput() / (1 << 20) << " MiB/s), " << pool_total * 1e3 << " ms until complete" << std::endl;
+    std::cout << "  stalled " << stats.stall_seconds * 1e3 << " ms, direct uploads " << stats.direct_uploads
+              << ", batch latency avg " << stats.average_latency() * 1e3 << " ms / max " << stats.max_latency * 1e3 << " ms" << std::endl;
+    return EXIT_SUCCESS;
+}
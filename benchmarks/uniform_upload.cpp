@@ -0,0 +1,142 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+//CPU cost per draw of setting uniforms one glUniform* call at a time versus a std140 agl::uniform_block upload,
+//after checking that setting one member uploads only that member's bytes
+
+#include<cstdlib>
+#include<cstring>
+#include<vector>
+
+#include "bench_util.hpp"
+
+struct draw_params {
+    glm::mat4 model;
+    glm::mat4 view_projection;
+    glm::vec4 color;
+    glm::vec3 light_direction;
+    float time;
+};
+
+template<>
+struct agl::block_members<draw_params> {
+    constexpr static auto members = std::make_tuple(
+        agl::block_member{"model", &draw_params::model},
+        agl::block_member{"view_projection", &draw_params::view_projection},
+        agl::block_member{"color", &draw_params::color},
+        agl::block_member{"light_direction", &draw_params::light_direction},
+        agl::block_member{"time", &draw_params::time}
+    );
+};
+
+constexpr int DRAWS = 200000;
+
+const char* UNIFORM_VERTEX = R"(#version 450 core
+uniform mat4 model;
+uniform mat4 view_projection;
+uniform vec4 color;
+uniform vec3 light_direction;
+uniform float time;
+out vec4 shade;
+void main() {
+    shade = color * max(dot(light_direction, vec3(0, 0, 1)), time);
+    gl_Position = view_projection * model * vec4(0, 0, 0, 1);
+}
+)";
+const char* BLOCK_VERTEX = R"(#version 450 core
+layout(std140, binding = 0) uniform draw_params {
+    mat4 model;
+    mat4 view_projection;
+    vec4 color;
+    vec3 light_direction;
+    float time;
+};
+out vec4 shade;
+void main() {
+    shade = color * max(dot(light_direction, vec3(0, 0, 1)), time);
+    gl_Position = view_projection * model * vec4(0, 0, 0, 1);
+}
+)";
+const char* FRAGMENT = R"(#version 450 core
+in vec4 shade;
+out vec4 result;
+void main() {
+    result = shade;
+}
+)";
+
+int main() {
+    if(!agl_bench::create_headless_context()) {
+        return EXIT_FAILURE;
+    }
+    agl::program uniforms;
+    agl::program blocks;
+    if(!agl_bench::build_program(uniforms, UNIFORM_VERTEX, FRAGMENT) || !agl_bench::build_program(blocks, BLOCK_VERTEX, FRAGMENT)) {
+        return EXIT_FAILURE;
+    }
+
+    agl::vertex_array empty;
+    empty.bind();
+    glEnable(GL_RASTERIZER_DISCARD);
+
+    draw_params params{glm::mat4(1.0f), glm::mat4(1.0f), glm::vec4(1.0f), glm::vec3(0.0f, 0.0f, 1.0f), 0.0f};
+
+    uniforms.bind();
+    GLint model = uniforms.uniform_location("model");
+    GLint view_projection = uniforms.uniform_location("view_projection");
+    GLint color = uniforms.uniform_location("color");
+    GLint light_direction = uniforms.uniform_location("light_direction");
+    GLint time = uniforms.uniform_location("time");
+    glFinish();
+
+    auto start = agl_bench::clock::now();
+    for(int draw = 0; draw < DRAWS; draw++) {
+        params.model[3].x = float(draw);
+        agl::program::bound::set_uniform(model, params.model);
+        agl::program::bound::set_uniform(view_projection, params.view_projection);
+        agl::program::bound::set_uniform(color, params.color);
+        agl::program::bound::set_uniform(light_direction, params.light_direction);
+        agl::program::bound::set_uniform(time, params.time);
+        glDrawArrays(GL_POINTS, 0, 1);
+    }
+    glFinish();
+    double uniform_seconds = agl_bench::seconds_since(start);
+
+    blocks.bind();
+    agl::uniform_block<draw_params> block;
+    if(!block.validate(blocks, "draw_params")) {
+        return EXIT_FAILURE;
+    }
+
+    //A per-member set uploads exactly that member: clear the buffer behind the staging copy's back, then only
+    //the buffer must read back as zeros apart from color's new bytes
+    block.set(params);
+    block.upload();
+    std::vector<std::byte> uploaded(block.size);
+    block.get_buffer().sub_data(0, block.size, uploaded.data());
+    const glm::vec4 new_color(0.25f, 0.5f, 0.75f, 1.0f);
+    block.set(&draw_params::color, new_color);
+    block.upload();
+    glGetNamedBufferSubData(block.get_buffer().id(), 0, block.size, uploaded.data());
+    std::vector<std::byte> expected(block.size);
+    std::memcpy(expected.data() + agl::uniform_block<draw_params>::info::offsets[2], &new_color, sizeof(new_color));
+    if(uploaded != expected) {
+        std::cerr << "Error: set(&draw_params::color) did not upload exactly color's bytes!" << std::endl;
+        return EXIT_FAILURE;
+    }
+    glFinish();
+
+    start = agl_bench::clock::now();
+    for(int draw = 0; draw < DRAWS; draw++) {
+        params.model[3].x = float(draw);
+        block.set(params);
+        block.bind(0);
+        glDrawArrays(GL_POINTS, 0, 1);
+    }
+    glFinish();
+    double block_seconds = agl_bench::seconds_since(start);
+
+    std::cout << "Block size: " << block.size << " bytes (std140)" << std::endl;
+    std::cout << "Per-uniform glUniform*: " << uniform_seconds * 1e9 / DRAWS << " ns/draw" << std::endl;
+    std::cout << "agl::uniform_block:     " << block_seconds * 1e9 / DRAWS << " ns/draw" << std::endl;
+    return EXIT_SUCCESS;
+}
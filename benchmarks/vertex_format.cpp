@@ -0,0 +1,159 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+//DRAWS draws per frame cycling through MESHES meshes that share one vertex format:
+//respecifying the attributes of one vertex array per mesh switch, rebinding only the vertex buffers
+//of a vertex array per format, and one cached vertex array per mesh from agl::vertex_array_cache
+
+#include<cstdint>
+#include<cstdlib>
+#include<random>
+#include<vector>
+
+#include "bench_util.hpp"
+
+constexpr int FRAMES = 20;
+constexpr int DRAWS = 50000;
+constexpr int MESHES = 64;
+constexpr GLuint TRIANGLES = 32;
+
+struct mesh_vertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 uv;
+    glm::vec<4, std::uint8_t> color;
+};
+
+template<>
+struct agl::vertex_members<mesh_vertex> {
+    constexpr static auto members = std::make_tuple(
+        agl::vertex_attribute{0, &mesh_vertex::position},
+        agl::vertex_attribute{1, &mesh_vertex::normal},
+        agl::vertex_attribute{2, &mesh_vertex::uv},
+        agl::vertex_attribute{3, &mesh_vertex::color, true}
+    );
+};
+
+const char* VERTEX = R"(#version 450 core
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec2 uv;
+layout(location = 3) in vec4 color;
+out vec4 shade;
+void main() {
+    shade = color * max(normal.z, uv.x);
+    gl_Position = vec4(position, 1);
+}
+)";
+const char* FRAGMENT = R"(#version 450 core
+in vec4 shade;
+out vec4 result;
+void main() {
+    result = shade;
+}
+)";
+
+int main() {
+    if(!agl_bench::create_headless_context()) {
+        return EXIT_FAILURE;
+    }
+
+    agl::program prog;
+    {
+        agl::vertex_shader vertex;
+        agl::fragment_shader fragment;
+        vertex.compile(VERTEX);
+        fragment.compile(FRAGMENT);
+        prog.attach_shader(vertex);
+        prog.attach_shader(fragment);
+        prog.link();
+        if(!prog.link_success()) {
+            std::cerr << prog.info_log() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::mt19937 random(3);
+    std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+    std::vector<mesh_vertex> vertices(TRIANGLES * 3);
+    std::vector<GLushort> indices(TRIANGLES * 3);
+    for(GLushort index = 0; index < indices.size(); index++) {
+        indices[index] = index;
+    }
+    std::vector<agl::buffer> vertex_buffers(MESHES);
+    std::vector<agl::buffer> index_buffers(MESHES);
+    for(int mesh = 0; mesh < MESHES; mesh++) {
+        for(mesh_vertex& vertex : vertices) {
+            vertex = {
+                glm::vec3(coordinate(random), coordinate(random), 0.0f), glm::vec3(0.0f, 0.0f, 1.0f),
+                glm::vec2(coordinate(random), coordinate(random)), glm::vec<4, std::uint8_t>(255, 255, 255, 255)
+            };
+        }
+        vertex_buffers[mesh].storage(vertices.size() * sizeof(mesh_vertex), vertices.data(), 0);
+        index_buffers[mesh].storage(indices.size() * sizeof(GLushort), indices.data(), 0);
+    }
+
+    std::uniform_int_distribution<int> pick_mesh(0, MESHES - 1);
+    std::vector<int> order(DRAWS);
+    for(int& mesh : order) {
+        mesh = pick_mesh(random);
+    }
+
+    agl::vertex_format const& format = agl::vertex_format::of<mesh_vertex>();
+    auto draw = [] {
+        glDrawElements(GL_TRIANGLES, TRIANGLES * 3, GL_UNSIGNED_SHORT, nullptr);
+    };
+
+    glEnable(GL_RASTERIZER_DISCARD);
+    prog.bind();
+
+    agl::vertex_array respecified;
+    auto start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        for(int mesh : order) {
+            format.apply(respecified);
+            agl::buffer* streams[] = {&vertex_buffers[mesh]};
+            format.bind_buffers(respecified, streams);
+            respecified.element_buffer(index_buffers[mesh]);
+            respecified.bind();
+            draw();
+        }
+        glFinish();
+    }
+    double respecify_seconds = agl_bench::seconds_since(start);
+
+    agl::vertex_array shared;
+    format.apply(shared);
+    start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        for(int mesh : order) {
+            agl::buffer* streams[] = {&vertex_buffers[mesh]};
+            format.bind_buffers(shared, streams);
+            shared.element_buffer(index_buffers[mesh]);
+            shared.bind();
+            draw();
+        }
+        glFinish();
+    }
+    double rebind_seconds = agl_bench::seconds_since(start);
+
+    agl::vertex_array_cache cache;
+    start = agl_bench::clock::now();
+    for(int frame = 0; frame < FRAMES; frame++) {
+        for(int mesh : order) {
+            agl::buffer* streams[] = {&vertex_buffers[mesh]};
+            cache.get(format, streams, &index_buffers[mesh]).bind();
+            draw();
+        }
+        glFinish();
+    }
+    double cached_seconds = agl_bench::seconds_since(start);
+    agl::vertex_array_cache::statistics stats = cache.stats();
+
+    std::cout << FRAMES << " frames of " << DRAWS << " draws over " << MESHES << " meshes, "
+              << format.attributes().size() << " attributes, stride " << format.streams()[0].stride << std::endl;
+    std::cout << "Respecify per switch:  " << respecify_seconds * 1e3 / FRAMES << " ms/frame" << std::endl;
+    std::cout << "Rebind buffers:        " << rebind_seconds * 1e3 / FRAMES << " ms/frame" << std::endl;
+    std::cout << "vertex_array_cache:    " << cached_seconds * 1e3 / FRAMES << " ms/frame, "
+              << stats.vertex_arrays << " vertex arrays, " << stats.hits << " hits" << std::endl;
+    return EXIT_SUCCESS;
+}
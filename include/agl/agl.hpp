@@ -10,5 +10,25 @@
 #include "agl/opengl.hpp"
 #include "agl/objects.hpp"
 #include "agl/context_util.hpp"
+#include "agl/streaming_buffer.hpp"
+#include "agl/frame_pacer.hpp"
+#include "agl/profiler.hpp"
+#include "agl/uniform_block.hpp"
+#include "agl/program_cache.hpp"
+#include "agl/program_builder.hpp"
+#include "agl/resource_loader.hpp"
+#include "agl/texture_upload.hpp"
+#include "agl/readback.hpp"
+#include "agl/render_target.hpp"
+#include "agl/draw_batch.hpp"
+#include "agl/arena.hpp"
+#include "agl/render_queue.hpp"
+#include "agl/command_list.hpp"
+#include "agl/vertex_format.hpp"
+#include "agl/deletion_queue.hpp"
+#include "agl/debug_output.hpp"
+#include "agl/compute.hpp"
+#include "agl/gpu_culling.hpp"
+#include "agl/texture_table.hpp"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,66 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_ARENA_HPP
+#define AGL_ARENA_HPP
+
+#include<vector>
+#include<memory>
+#include<span>
+#include<new>
+#include<cstddef>
+#include<cstring>
+#include<type_traits>
+#include<utility>
+
+namespace agl
+{
+
+//Bump allocator for per-frame data, reset() keeps the blocks for the next frame
+//Only holds trivially destructible types, nothing is destroyed on reset
+struct arena {
+public:
+    arena(arena&) = delete;
+
+    explicit arena(size_t block_size = 64 * 1024);
+    arena(arena&&) noexcept;
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template<typename T, typename... Args>
+    T* make(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "arena never runs destructors");
+        return new(this->allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+    template<typename T>
+    std::span<T> copy(std::span<const T> values) {
+        static_assert(std::is_trivially_copyable_v<T>, "arena copies are memcpy");
+        if(values.empty()) {
+            return {};
+        }
+        T* data = static_cast<T*>(this->allocate(values.size_bytes(), alignof(T)));
+        std::memcpy(data, values.data(), values.size_bytes());
+        return {data, values.size()};
+    }
+
+    void reset();
+    //Bytes handed out since the last reset
+    size_t used() const;
+    //Bytes held by every block
+    size_t capacity() const;
+
+private:
+    struct block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    std::vector<block> _blocks;
+    size_t _block_size;
+    size_t _current;
+    size_t _head;
+    size_t _used;
+};
+
+}
+
+#endif //AGL_ARENA_HPP
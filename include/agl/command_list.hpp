@@ -0,0 +1,98 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_COMMAND_LIST_HPP
+#define AGL_COMMAND_LIST_HPP
+
+#include<span>
+#include<cstddef>
+
+#include "agl/opengl.hpp"
+#include "agl/objects.hpp"
+#include "agl/arena.hpp"
+
+namespace agl
+{
+
+//CPU side list of binds, uniform sets, buffer updates and draws. Recording never calls into GL, so any
+//thread can record its own list (one list per thread), the context's thread then executes the lists in order.
+//Recorded objects must outlive execute, buffer update data and uniform values are copied when recorded.
+struct command_list {
+public:
+    command_list(command_list&) = delete;
+
+    explicit command_list(size_t arena_block_size = 64 * 1024);
+    command_list(command_list&&) noexcept;
+
+    void bind_program(program&);
+    void bind_vertex_array(vertex_array&);
+    void bind_texture(GLuint unit, any_texture&);
+    void bind_buffer(GLenum target, buffer&);
+    void bind_buffer_base(GLenum target, GLuint index, buffer&);
+    void bind_buffer_range(GLenum target, GLuint index, buffer&, GLintptr offset, GLsizeiptr size);
+
+    //Applies to the program bound when the list executes, through program::bound::set_uniform
+    template<typename T>
+    void set_uniform(GLint location, T const& value) {
+        this->record([location, value]() {
+            program::bound::set_uniform(location, value);
+        });
+    }
+    template<typename T>
+    void set_uniform(GLint location, std::span<const T> values) {
+        std::span<T> copied = this->_arena.copy(values);
+        this->record([location, copied]() {
+            program::bound::set_uniform(location, static_cast<GLsizei>(copied.size()), copied.data());
+        });
+    }
+
+    void buffer_update(buffer&, GLintptr offset, std::span<const std::byte> data);
+
+    void draw_arrays(GLenum mode, GLint first, GLsizei count, GLsizei instance_count = 1, GLuint base_instance = 0);
+    void draw_elements(GLenum mode, GLsizei count, GLenum index_type, GLuint first_index,
+                       GLint base_vertex = 0, GLsizei instance_count = 1, GLuint base_instance = 0);
+    //For anything else, function runs on the context's thread with user
+    void call(void (*function)(void* user), void* user);
+
+    //On the context's thread, lists recorded for one frame are executed in the order they should draw
+    void execute() const;
+    //Drops the commands, the arena blocks are kept for the next recording
+    void reset();
+    size_t size() const;
+    size_t memory_used() const;
+
+private:
+    struct node {
+        node* next;
+        void (*run)(node const*);
+    };
+    //Commands are their replay function's captures, stored inline in the arena
+    template<typename Function>
+    struct recorded : node {
+        Function function;
+
+        static void run(node const* command) {
+            static_cast<recorded const*>(command)->function();
+        }
+    };
+
+    template<typename Function>
+    void record(Function const& function) {
+        auto* added = this->_arena.make<recorded<Function>>(recorded<Function>{{nullptr, &recorded<Function>::run}, function});
+        if(this->_tail != nullptr) {
+            this->_tail->next = added;
+        } else {
+            this->_head = added;
+        }
+        this->_tail = added;
+        this->_size++;
+    }
+
+    arena _arena;
+    node* _head;
+    node* _tail;
+    size_t _size;
+};
+
+}
+
+#endif //AGL_COMMAND_LIST_HPP
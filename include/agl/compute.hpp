@@ -0,0 +1,154 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_COMPUTE_HPP
+#define AGL_COMPUTE_HPP
+
+#include<array>
+#include<vector>
+#include<span>
+#include<unordered_map>
+#include<type_traits>
+#include<cstddef>
+#include<cstdint>
+
+#include "agl/opengl.hpp"
+#include "agl/objects.hpp"
+
+namespace agl
+{
+
+//Record layout glDispatchComputeIndirect reads (DispatchIndirectCommand)
+struct dispatch_indirect_command {
+    GLuint groups_x;
+    GLuint groups_y;
+    GLuint groups_z;
+};
+
+//count elements of T (laid out std430 on the GLSL side) starting offset bytes into buf,
+//offset must be a multiple of GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT to be bound
+template<typename T>
+struct storage_view {
+
+static_assert(std::is_trivially_copyable_v<T>, "storage_view elements are copied to and from the GPU as bytes!");
+
+public:
+    storage_view(buffer& buf, GLsizeiptr count, GLintptr offset = 0)
+        : buf(&buf),
+          offset(offset),
+          count(count)
+    {}
+
+    GLsizeiptr size() const {
+        return this->count * static_cast<GLsizeiptr>(sizeof(T));
+    }
+    //Uploads values to elements [first, first + values.size())
+    void write(std::span<const T> values, GLsizeiptr first = 0) {
+        this->buf->sub_data(this->offset + first * static_cast<GLintptr>(sizeof(T)),
+                            static_cast<GLsizeiptr>(values.size_bytes()), values.data());
+    }
+
+    buffer* buf;
+    GLintptr offset;
+    GLsizeiptr count;
+};
+
+//A linked compute program and its local size (layout(local_size_x = ...) in;), queried once
+struct compute_kernel {
+public:
+    explicit compute_kernel(program&);
+
+    program& get_program();
+    glm::uvec3 local_size() const;
+    //Work groups covering invocations, rounded up per axis
+    glm::uvec3 groups_for(glm::uvec3 invocations) const;
+
+private:
+    program* _program;
+    glm::uvec3 _local_size;
+};
+
+//Issues glMemoryBarrier only where incoherent shader writes (storage buffers, images, atomic counters) to a buffer
+//are followed by a read of it that no barrier issued since covers: each write stamps the buffer with an epoch,
+//each barrier bit remembers the epoch it was last issued at
+struct barrier_tracker {
+public:
+    struct statistics {
+        //glMemoryBarrier calls
+        std::uint64_t barriers;
+        //Reads that needed no barrier
+        std::uint64_t skipped;
+    };
+
+    //Commands issued so far (a dispatch or draw) wrote buf from shaders
+    void written(buffer& buf);
+    //Before a command reads buf through the paths in barrier_bits (e.g. GL_COMMAND_BARRIER_BIT for indirect
+    //arguments, GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT for vertex pulling), true if a barrier was issued
+    bool read(buffer& buf, GLbitfield barrier_bits);
+    //Unconditional, e.g. before reading a buffer written outside the tracker's knowledge
+    void barrier(GLbitfield barrier_bits);
+
+    statistics stats() const;
+    void reset_stats();
+
+private:
+    std::uint64_t _epoch = 0;
+    std::unordered_map<GLuint, std::uint64_t> _written;
+    //Epoch each barrier bit was last issued at, indexed by bit position
+    std::array<std::uint64_t, 32> _covered{};
+    statistics _stats{};
+};
+
+enum class storage_access {
+    read,
+    write,
+    read_write
+};
+
+//Binds storage buffers to indexed slots and dispatches compute kernels, inserting the barriers
+//its barrier_tracker finds necessary between dispatches (and draws that report their reads to barriers())
+struct compute_dispatcher {
+public:
+    compute_dispatcher(compute_dispatcher&) = delete;
+
+    compute_dispatcher() = default;
+    compute_dispatcher(compute_dispatcher&&) noexcept = default;
+
+    //Used by following dispatches until the slot is rebound or unbound (each dispatch rebinds it,
+    //a no-op unless something else bound the index in between)
+    template<typename T>
+    void bind_storage(GLuint index, storage_view<T> const& view, storage_access access) {
+        this->bind_storage(index, *view.buf, view.offset, view.size(), access);
+    }
+    void bind_storage(GLuint index, buffer& buf, GLintptr offset, GLsizeiptr size, storage_access access);
+    //The dispatcher stops tracking the slot, the GL binding is left as is
+    void unbind_storage(GLuint index);
+
+    void dispatch(compute_kernel&, glm::uvec3 groups);
+    //Enough work groups of the kernel's local size to cover invocations
+    void dispatch_threads(compute_kernel&, glm::uvec3 invocations);
+    //Group counts read on the GPU from a dispatch_indirect_command at offset in args
+    void dispatch_indirect(compute_kernel&, buffer& args, GLintptr offset = 0);
+
+    barrier_tracker& barriers();
+    std::uint64_t dispatches() const;
+
+private:
+    struct slot {
+        GLuint index;
+        buffer* buf;
+        GLintptr offset;
+        GLsizeiptr size;
+        storage_access access;
+    };
+
+    void before_dispatch(compute_kernel&);
+    void after_dispatch();
+
+    std::vector<slot> _slots;
+    barrier_tracker _barriers;
+    std::uint64_t _dispatches = 0;
+};
+
+}
+
+#endif //AGL_COMPUTE_HPP
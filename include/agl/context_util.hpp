@@ -5,13 +5,46 @@ namespace agl {
 
 using load_proc = void*(*)(const char*);
 
+//Window system hooks for contexts that share objects with the render thread's context (see resource_loader)
+struct context_factory {
+    //Called on the render thread with its context current, nullptr = failure
+    void* (*create)(void* user);
+    //Called on the thread that will use the context, nullptr releases the thread's context, true = success
+    bool (*make_current)(void* context, void* user);
+    //Called on the render thread once no thread uses the context
+    void (*destroy)(void* context, void* user);
+    void* user;
+};
+
 //true = success
 bool init();
 //true = success
 bool init(load_proc);
+//true = success, also registers the factory used by resource_loader
+bool init(load_proc, context_factory const&);
+
+void set_context_factory(context_factory const&);
+//nullptr if no factory was registered
+context_factory const* get_context_factory();
 
+//Messages of low severity and above through a process-wide debug_output writing to std::cerr,
+//use a debug_output directly to filter them or to get per-frame summaries
 void set_gl_debug_logging(bool);
 
+//true if init found GL 4.5 or ARB_direct_state_access (always false when built with AGL_NO_DSA),
+//AGL objects then edit through glCreate*/glNamed* instead of binding
+bool direct_state_access();
+//true if init found GL 4.4 or ARB_multi_bind (glBindTextures/glBindSamplers/glBindBuffersRange)
+bool multi_bind();
+//true if init found KHR/ARB_parallel_shader_compile, GL_COMPLETION_STATUS_KHR can then be polled
+//without waiting for the driver's compiler threads
+bool parallel_shader_compile();
+//true if init found GL 4.6 or ARB_indirect_parameters (glMultiDraw*IndirectCount reading the draw count from
+//GL_PARAMETER_BUFFER)
+bool indirect_parameters();
+//true if init found ARB_bindless_texture (64-bit texture handles sampled without binding)
+bool bindless_texture();
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,146 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_DEBUG_OUTPUT_HPP
+#define AGL_DEBUG_OUTPUT_HPP
+
+#include<memory>
+#include<atomic>
+#include<thread>
+#include<chrono>
+#include<span>
+#include<string>
+#include<string_view>
+#include<unordered_map>
+#include<cstddef>
+#include<cstdint>
+
+#include "agl/opengl.hpp"
+
+namespace agl
+{
+
+//KHR_debug output that stays cheap enough to leave enabled: messages are filtered by the driver
+//(glDebugMessageControl), the callback only copies them into a lock-free ring and bumps counters,
+//and a background thread drains, deduplicates, formats and writes them
+struct debug_output {
+public:
+    struct config {
+        //Less severe messages are disabled in the driver, GL_DEBUG_SEVERITY_NOTIFICATION keeps everything
+        GLenum min_severity = GL_DEBUG_SEVERITY_LOW;
+        //GL_DEBUG_OUTPUT_SYNCHRONOUS, messages then arrive on the calling thread inside the offending call
+        bool synchronous = false;
+        //Repeats of a message (same source, type, id and text) are counted instead of written
+        bool deduplicate = true;
+        //How often the counted repeats are written ("... (xN)"), a message still repeating after that is
+        //written in full again
+        std::chrono::milliseconds repeat_interval = std::chrono::seconds(1);
+        //Rounded up to a power of two, messages arriving while the ring is full are counted and dropped
+        size_t ring_capacity = 1024;
+        //How often the drain thread checks the ring
+        std::chrono::milliseconds poll_interval = std::chrono::milliseconds(5);
+        //Called on the drain thread with each formatted message, nullptr writes to std::cerr
+        void (*sink)(std::string_view line, void* user) = nullptr;
+        void* user = nullptr;
+    };
+
+    //Counted in the callback, before deduplication
+    struct summary {
+        std::uint64_t messages;
+        std::uint64_t errors;
+        std::uint64_t high;
+        std::uint64_t medium;
+        std::uint64_t low;
+        std::uint64_t notifications;
+        //Not written because the same message was already written in this repeat_interval
+        std::uint64_t duplicates;
+        //Lost to a full ring
+        std::uint64_t dropped;
+    };
+
+    //Longer messages are truncated
+    static constexpr size_t MAX_MESSAGE_LENGTH = 256;
+
+    debug_output(debug_output&) = delete;
+    debug_output(debug_output&&) = delete;
+
+    debug_output();
+    debug_output(config const&);
+    //Disables, then writes the repeat counts not written yet
+    ~debug_output();
+
+    //With the context current: applies the severity filter, sets the callback and starts the drain thread
+    void enable();
+    void disable();
+    bool enabled() const;
+
+    //glDebugMessageControl, GL_DONT_CARE matches everything, needs the context current
+    void filter(GLenum source, GLenum type, GLenum severity, bool enable);
+    //Message ids are only meaningful for one source and type
+    void filter(GLenum source, GLenum type, std::span<const GLuint> ids, bool enable);
+
+    //Counts since the previous end_frame, cheap enough to call every frame
+    summary end_frame();
+    //Counts since enable
+    summary totals() const;
+
+    //Blocks until every message received so far has been written
+    void drain();
+
+private:
+    struct message {
+        //Written by the producer, ready once it equals the position plus one
+        std::atomic<std::uint64_t> sequence;
+        GLenum source;
+        GLenum type;
+        GLenum severity;
+        GLuint id;
+        std::uint32_t length;
+        char text[MAX_MESSAGE_LENGTH];
+    };
+    struct counters {
+        std::atomic<std::uint64_t> messages = 0;
+        std::atomic<std::uint64_t> errors = 0;
+        std::atomic<std::uint64_t> high = 0;
+        std::atomic<std::uint64_t> medium = 0;
+        std::atomic<std::uint64_t> low = 0;
+        std::atomic<std::uint64_t> notifications = 0;
+        std::atomic<std::uint64_t> duplicates = 0;
+        std::atomic<std::uint64_t> dropped = 0;
+    };
+    struct repeat {
+        std::uint64_t count;
+        std::string line;
+    };
+
+    static void GLAPIENTRY callback(GLenum source, GLenum type, GLuint id, GLenum severity,
+                                    GLsizei length, const GLchar* text, const void* user);
+    void receive(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* text);
+
+    void run();
+    //Drain thread, true if a message was written
+    bool consume();
+    void write(message const&);
+    //Writes the repeat counts and forgets the messages seen so far, drain thread (or after it stopped)
+    void write_repeats();
+
+    config _config;
+    std::unique_ptr<message[]> _ring;
+    size_t _mask;
+    //Producers claim positions with compare-exchange (driver threads may call back concurrently)
+    alignas(64) std::atomic<std::uint64_t> _enqueue = 0;
+    alignas(64) std::atomic<std::uint64_t> _dequeue = 0;
+
+    counters _frame;
+    counters _total;
+
+    std::atomic<bool> _stop = false;
+    std::thread _drain;
+    bool _enabled = false;
+
+    //Drain thread only
+    std::unordered_map<std::uint64_t, repeat> _seen;
+};
+
+}
+
+#endif //AGL_DEBUG_OUTPUT_HPP
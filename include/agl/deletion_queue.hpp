@@ -0,0 +1,108 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_DELETION_QUEUE_HPP
+#define AGL_DELETION_QUEUE_HPP
+
+#include<array>
+#include<vector>
+#include<deque>
+#include<mutex>
+#include<shared_mutex>
+#include<atomic>
+#include<optional>
+#include<cstddef>
+#include<cstdint>
+
+#include "agl/opengl.hpp"
+#include "agl/objects.hpp"
+
+namespace agl
+{
+
+enum class deletable_type {
+    buffer,
+    shader,
+    program,
+    vertex_array,
+    query,
+    program_pipeline,
+    transform_feedback,
+    sampler,
+    texture,
+    renderbuffer,
+    framebuffer
+};
+constexpr size_t DELETABLE_TYPE_COUNT = 11;
+
+//Opt-in: while a queue is installed, object destructors on any thread hand their names to it instead of
+//calling glDelete*. flush() fences the names queued since the last flush and deletes earlier batches
+//in bulk once their fence signals, so unloads neither stall on objects the GPU still reads nor need the GL thread.
+//Fences are still deleted directly (the queue fences its own batches with them).
+struct deletion_queue {
+public:
+    struct statistics {
+        std::uint64_t enqueued;
+        std::uint64_t deleted;
+        //glDelete* calls issued, one per type per batch for the types that delete in bulk
+        std::uint64_t delete_calls;
+        std::uint64_t batches;
+    };
+
+    deletion_queue(deletion_queue&) = delete;
+    deletion_queue(deletion_queue&&) = delete;
+
+    deletion_queue() = default;
+    //Uninstalls (waiting for destructors handing it names), then deletes everything still queued,
+    //needs a current context
+    ~deletion_queue();
+
+    //One queue is installed at a time, installing replaces the previous one
+    void install();
+    void uninstall();
+    //Called by destructors, false = no queue is installed and the caller deletes the name itself
+    static bool defer(deletable_type, GLuint name);
+
+    //Once per frame on a thread with a current context, forgets that thread's cached bindings
+    //when names were deleted (glDelete* unbinds them)
+    void flush();
+    //flush only forgets the calling thread's cached bindings, while GL may hand the deleted names out again.
+    //Other threads that bind objects call this before binding (e.g. once per frame or job) to forget theirs
+    //if names were deleted since they last did (resource_loader workers forget after every job already)
+    static void sync_thread_bindings();
+    //Waits for and deletes every queued name
+    void finish();
+    size_t pending() const;
+
+    statistics stats() const;
+
+private:
+    struct batch {
+        std::array<std::vector<GLuint>, DELETABLE_TYPE_COUNT> names;
+        std::optional<fence> retired;
+
+        bool empty() const;
+        size_t size() const;
+    };
+
+    void enqueue(deletable_type, GLuint name);
+    void seal();
+    void delete_batch(batch&);
+    void forget_deleted_bindings();
+
+    mutable std::mutex _mutex;
+    batch _incoming;
+    std::deque<batch> _batches;
+    size_t _pending = 0;
+    statistics _stats{};
+
+    //Held shared by defer while it enqueues, uninstall takes it exclusively
+    static std::shared_mutex _install_mutex;
+    static std::atomic<deletion_queue*> _installed;
+    //Bumped whenever a batch is deleted
+    static std::atomic<std::uint64_t> _deletions;
+    static thread_local std::uint64_t _synced_deletions;
+};
+
+}
+
+#endif //AGL_DELETION_QUEUE_HPP
@@ -0,0 +1,86 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_DRAW_BATCH_HPP
+#define AGL_DRAW_BATCH_HPP
+
+#include<vector>
+#include<cstddef>
+#include<cstdint>
+
+#include "agl/opengl.hpp"
+#include "agl/objects.hpp"
+#include "agl/streaming_buffer.hpp"
+
+namespace agl
+{
+
+//Record layout glMultiDrawElementsIndirect reads (DrawElementsIndirectCommand)
+struct draw_elements_command {
+    GLuint count;
+    GLuint instance_count;
+    GLuint first_index;
+    GLint base_vertex;
+    GLuint base_instance;
+};
+
+//Queues indexed draws, sorts them by program, vertex array and texture and submits each run of equal state
+//with one glMultiDrawElementsIndirect from a persistently mapped indirect buffer
+struct draw_batch {
+public:
+    struct statistics {
+        std::uint64_t draws;
+        std::uint64_t multi_draws;
+        //Program, vertex array and texture switches between runs, each counted (like render_queue)
+        std::uint64_t state_changes;
+        //Draws past max_draws in a frame, submitted one glDrawElements* call at a time
+        std::uint64_t overflow_draws;
+    };
+
+    draw_batch(draw_batch&) = delete;
+
+    //Room for max_draws commands per frame, frame_count frames in flight
+    explicit draw_batch(GLuint max_draws, GLuint frame_count = 3);
+    draw_batch(draw_batch&&) noexcept;
+
+    //prog, vao (which holds the element buffer) and texture (unit 0, may be nullptr) must outlive submit
+    void add(program& prog, vertex_array& vao, any_texture* texture,
+             GLenum mode, GLenum index_type, draw_elements_command const& command);
+    //Issues and clears the queued draws
+    void submit();
+    //Fences this frame's commands, call once per frame after the last submit
+    void next_frame();
+    void clear();
+    size_t size() const;
+
+    //glMultiDrawElementsIndirectCount with the run length in GL_PARAMETER_BUFFER, only if indirect_parameters()
+    void use_indirect_count(bool);
+
+    statistics stats() const;
+    void reset_stats();
+
+private:
+    struct queued {
+        GLuint program_id;
+        GLuint vao_id;
+        GLuint texture_id;
+        GLenum mode;
+        GLenum index_type;
+        program* prog;
+        vertex_array* vao;
+        any_texture* texture;
+        draw_elements_command command;
+    };
+
+    static bool same_state(queued const&, queued const&);
+    void apply_state(queued const&);
+
+    streaming_buffer _indirect;
+    std::vector<queued> _queued;
+    std::vector<std::uint32_t> _order;
+    bool _indirect_count;
+    statistics _stats;
+};
+
+}
+
+#endif //AGL_DRAW_BATCH_HPP
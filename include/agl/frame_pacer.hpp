@@ -0,0 +1,50 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_FRAME_PACER_HPP
+#define AGL_FRAME_PACER_HPP
+
+#include<vector>
+#include<optional>
+#include<chrono>
+#include<cstdint>
+
+#include "agl/opengl.hpp"
+#include "agl/objects.hpp"
+
+namespace agl
+{
+
+//Limits the number of frames the CPU may run ahead of the GPU without draining the pipeline
+struct frame_pacer {
+public:
+    frame_pacer(frame_pacer&) = delete;
+
+    frame_pacer(GLuint max_frames_in_flight = 2);
+    frame_pacer(frame_pacer&&) noexcept = default;
+
+    //Blocks until fewer than max_frames_in_flight frames are pending on the GPU
+    void begin_frame();
+    //Fences every command issued since begin_frame
+    void end_frame();
+
+    GLuint max_frames_in_flight() const;
+    GLuint frames_in_flight();
+    std::uint64_t frame_count() const;
+
+    //Time the CPU spent blocked in the most recent begin_frame
+    std::chrono::nanoseconds last_stall() const;
+    std::chrono::nanoseconds total_stall() const;
+    std::uint64_t stalled_frames() const;
+
+private:
+    std::vector<std::optional<fence>> _fences;
+    std::uint64_t _frame;
+
+    std::chrono::nanoseconds _last_stall;
+    std::chrono::nanoseconds _total_stall;
+    std::uint64_t _stalled_frames;
+};
+
+}
+
+#endif //AGL_FRAME_PACER_HPP
@@ -0,0 +1,108 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_GPU_CULLING_HPP
+#define AGL_GPU_CULLING_HPP
+
+#include<optional>
+#include<span>
+#include<cstddef>
+#include<cstdint>
+
+#include "agl/opengl.hpp"
+#include "agl/objects.hpp"
+#include "agl/compute.hpp"
+#include "agl/draw_batch.hpp"
+
+namespace agl
+{
+
+//std430 layout of an instance in the culling shader: world space bounding sphere (xyz center, w radius)
+//and the index of its mesh in gpu_culler::set_meshes
+struct cull_instance {
+    glm::vec4 sphere;
+    GLuint mesh;
+    GLuint padding[3];
+};
+
+//Frustum and Hi-Z occlusion culling in compute: every instance is tested against the view projection's planes
+//and a max-depth pyramid, survivors are appended (atomic counter) to an indirect buffer of draw_elements_command
+//that draw() submits with one glMultiDrawElementsIndirectCount. Each command draws one instance with
+//base_instance = its index, so per-instance vertex attributes (divisor 1) fetch that instance's data.
+//Without indirect_parameters() the commands stay at the instance's index (culled ones drawing 0 instances)
+//and are submitted with glMultiDrawElementsIndirect
+struct gpu_culler {
+public:
+    struct statistics {
+        std::uint64_t culls;
+        std::uint64_t pyramids;
+        std::uint64_t draws;
+    };
+
+    gpu_culler(gpu_culler&) = delete;
+    gpu_culler(gpu_culler&&) = delete;
+
+    //Compiles the culling and pyramid kernels and allocates the buffers, needs GL 4.3 and GL 4.4 or
+    //ARB_buffer_storage. valid() is false without them or if a kernel failed to link, the culler then does nothing
+    explicit gpu_culler(GLuint max_instances);
+
+    bool valid() const;
+    GLuint max_instances() const;
+
+    //Command templates for each mesh, their instance_count and base_instance are ignored
+    void set_meshes(std::span<const draw_elements_command> meshes);
+    //At most max_instances, replaces the previous instances
+    void set_instances(std::span<const cull_instance> instances);
+
+    //Max-depth pyramid of depth (level 0, width x height, e.g. the previous frame's depth or a depth prepass of
+    //large occluders), used by the following culls until rebuilt. Depth is expected in [0, 1], nearer is smaller
+    void build_hi_z(texture_2d& depth, GLsizei width, GLsizei height);
+    //Forgets the pyramid, culls then only test the frustum
+    void clear_hi_z();
+
+    void cull(glm::mat4 const& view_projection);
+    //Draws the survivors of the last cull with the bound program and vertex array (holding the meshes'
+    //shared vertex and element buffers)
+    void draw(GLenum mode, GLenum index_type);
+
+    //Waits for the last cull, for statistics and tests
+    GLuint read_visible_count();
+
+    //Survivors' commands and (first GLuint) their count, e.g. to draw them with other state
+    buffer& commands();
+    buffer& count();
+
+    statistics stats() const;
+
+private:
+    bool build(program&, const char* source);
+
+    program _cull_program;
+    program _copy_program;
+    program _reduce_program;
+    std::optional<compute_kernel> _cull;
+    std::optional<compute_kernel> _copy;
+    std::optional<compute_kernel> _reduce;
+    bool _valid;
+
+    GLuint _max_instances;
+    GLuint _instance_count;
+    buffer _instances;
+    //Recreated when the mesh count changes
+    std::optional<buffer> _meshes;
+    GLuint _mesh_count;
+    buffer _commands;
+    buffer _count;
+
+    std::optional<texture_2d> _hi_z;
+    GLsizei _hi_z_width;
+    GLsizei _hi_z_height;
+    GLint _hi_z_levels;
+    bool _use_hi_z;
+
+    compute_dispatcher _dispatcher;
+    statistics _stats;
+};
+
+}
+
+#endif //AGL_GPU_CULLING_HPP
@@ -3,14 +3,25 @@
 #ifndef AGL_OBJECTS_HPP
 #define AGL_OBJECTS_HPP
 
-#include<unordered_map>
+#include<string>
 #include<string_view>
+#include<span>
+#include<utility>
+#include<vector>
+#include<cstddef>
+#include<cstdint>
 
 #include "agl/opengl.hpp"
+#include "agl/context_util.hpp"
+#include "agl/reflection.hpp"
 
 namespace agl 
 {
 
+//Forgets every binding AGL cached for the calling thread so the next bind of each object reaches GL,
+//for threads whose context shares objects that another thread may delete (see resource_loader)
+void forget_thread_bindings();
+
 struct buffer {
 public:
     buffer(buffer&) = delete;
@@ -20,11 +31,78 @@ public:
     ~buffer();
 
     void bind(GLenum target);
+    //Binds 0, e.g. so pixel transfers read client memory again after a GL_PIXEL_UNPACK_BUFFER upload
+    static void unbind(GLenum target);
+    //Indexed binding points (uniform, shader storage, atomic counter and transform feedback buffers)
+    void bind_base(GLenum target, GLuint index);
+    void bind_range(GLenum target, GLuint index, GLintptr offset, GLsizeiptr size);
     GLuint id();
 
+    //Without direct state access these bind to GL_COPY_WRITE_BUFFER to edit
+    void storage(GLsizeiptr size, const void* data, GLbitfield flags);
+    void data(GLsizeiptr size, const void* data, GLenum usage);
+    void sub_data(GLintptr offset, GLsizeiptr size, const void* data);
+    void* map_range(GLintptr offset, GLsizeiptr length, GLbitfield access);
+    void flush_mapped_range(GLintptr offset, GLsizeiptr length);
+    //false = the data store became corrupt while mapped and must be reinitialized
+    bool unmap();
+
+    constexpr static size_t TARGET_COUNT = 14;
+    //TARGET_COUNT for targets without a cache slot
+    constexpr static size_t target_slot(GLenum target) {
+        switch(target) {
+            case GL_ARRAY_BUFFER: return 0;
+            case GL_ATOMIC_COUNTER_BUFFER: return 1;
+            case GL_COPY_READ_BUFFER: return 2;
+            case GL_COPY_WRITE_BUFFER: return 3;
+            case GL_DISPATCH_INDIRECT_BUFFER: return 4;
+            case GL_DRAW_INDIRECT_BUFFER: return 5;
+            case GL_ELEMENT_ARRAY_BUFFER: return 6;
+            case GL_PIXEL_PACK_BUFFER: return 7;
+            case GL_PIXEL_UNPACK_BUFFER: return 8;
+            case GL_QUERY_BUFFER: return 9;
+            case GL_SHADER_STORAGE_BUFFER: return 10;
+            case GL_TEXTURE_BUFFER: return 11;
+            case GL_TRANSFORM_FEEDBACK_BUFFER: return 12;
+            case GL_UNIFORM_BUFFER: return 13;
+            default: return TARGET_COUNT;
+        }
+    }
+
+    constexpr static size_t INDEXED_TARGET_COUNT = 4;
+    //Indices past this are never cached
+    constexpr static GLuint MAX_CACHED_INDEX = 96;
+    //INDEXED_TARGET_COUNT for targets without indexed binding points
+    constexpr static size_t indexed_target_slot(GLenum target) {
+        switch(target) {
+            case GL_ATOMIC_COUNTER_BUFFER: return 0;
+            case GL_SHADER_STORAGE_BUFFER: return 1;
+            case GL_TRANSFORM_FEEDBACK_BUFFER: return 2;
+            case GL_UNIFORM_BUFFER: return 3;
+            default: return INDEXED_TARGET_COUNT;
+        }
+    }
+
 private:
+    friend void forget_thread_bindings();
+
     GLuint _id;
-    static thread_local std::unordered_map<GLenum, GLuint> _bindings;
+
+    struct indexed_binding {
+        GLuint id;
+        GLintptr offset;
+        //0 = whole buffer (glBindBufferBase)
+        GLsizeiptr size;
+    };
+
+    //Element array buffer binding is vertex array state, vertex_array invalidates it on rebind
+    friend struct vertex_array;
+    constexpr static GLuint UNKNOWN_BINDING = ~GLuint(0);
+
+    static thread_local GLuint _bindings[TARGET_COUNT];
+    static thread_local indexed_binding _indexed_bindings[INDEXED_TARGET_COUNT][MAX_CACHED_INDEX];
+    //One past the highest index ever cached per target, bounds the destructor's scan
+    static thread_local GLuint _indexed_high_water[INDEXED_TARGET_COUNT];
 };
 template<GLenum TARGET>
 struct single_binding_buffer : public buffer {
@@ -51,9 +129,22 @@ static_assert(
 
 private:
     using buffer::bind;
+    using buffer::bind_base;
+    using buffer::bind_range;
 
 public:
     void bind() {buffer::bind(TARGET);}
+    static void unbind() {buffer::unbind(TARGET);}
+    void bind_base(GLuint index) {
+        static_assert(buffer::indexed_target_slot(TARGET) != buffer::INDEXED_TARGET_COUNT,
+            "TARGET has no indexed binding points!");
+        buffer::bind_base(TARGET, index);
+    }
+    void bind_range(GLuint index, GLintptr offset, GLsizeiptr size) {
+        static_assert(buffer::indexed_target_slot(TARGET) != buffer::INDEXED_TARGET_COUNT,
+            "TARGET has no indexed binding points!");
+        buffer::bind_range(TARGET, index, offset, size);
+    }
 };
 using array_buffer = single_binding_buffer<GL_ARRAY_BUFFER>;
 using element_array_buffer = single_binding_buffer<GL_ELEMENT_ARRAY_BUFFER>;
@@ -61,8 +152,11 @@ using element_array_buffer = single_binding_buffer<GL_ELEMENT_ARRAY_BUFFER>;
 // Example: GL_COPY_READ_BUFFER should not be singly bound
 #ifndef AGL_GL_OBJECT_ACCESS
     #undef glGenBuffers
+    #undef glCreateBuffers
     #undef glDeleteBuffers
     #undef glBindBuffer
+    #undef glBindBufferBase
+    #undef glBindBufferRange
 #endif
 
 struct any_shader {
@@ -72,6 +166,8 @@ public:
     GLuint id();
 
     void compile(std::string_view source);
+    //Inserts defines right after the source's #version line
+    void compile(std::string_view source, std::string_view defines);
     bool compile_success() const;
     std::string info_log() const;
 
@@ -107,9 +203,8 @@ public:
     shader() {
         this->_id = glCreateShader(TYPE);
     }
-    shader(shader&& move) noexcept
-        : _id(move._id)
-    {
+    shader(shader&& move) noexcept {
+        this->_id = move._id;
         move._id = 0;
     }
 
@@ -127,6 +222,25 @@ using geometry_shader = shader<GL_GEOMETRY_SHADER>;
 using tess_control_shader = shader<GL_TESS_CONTROL_SHADER>;
 using tess_evaluation_shader = shader<GL_TESS_EVALUATION_SHADER>;
 
+//Shader stage chosen at runtime, for sources described by data rather than by type
+struct dynamic_shader : public any_shader {
+public:
+    dynamic_shader(dynamic_shader&) = delete;
+
+    explicit dynamic_shader(GLenum type);
+    dynamic_shader(dynamic_shader&&) noexcept;
+
+    GLenum type() const;
+
+private:
+    GLenum _type;
+};
+
+struct shader_source {
+    GLenum type;
+    std::string_view source;
+};
+
 struct program {
 public:
     program(program&) = delete;
@@ -139,11 +253,38 @@ public:
     GLuint id();
 
     void attach_shader(any_shader&);
+    //Shaders can be detached (and destroyed) once linking is done
+    void detach_shader(any_shader&);
+    //Reflects the program's active resources if linking succeeded
     void link();
     bool link_success() const;
     std::string info_log() const;
 
-    GLint uniform_location(const char*);
+    //Links from a blob previously returned by get_binary(), reflects on success,
+    //false if the driver rejects the format (e.g. after a driver update)
+    bool load_binary(GLenum format, std::span<const std::byte> binary);
+    //Empty if the driver does not provide binaries
+    std::vector<std::byte> get_binary(GLenum& format) const;
+
+    //Rebuilds the reflection table, link() already does this
+    void reflect();
+    program_reflection const& reflection() const;
+
+    //Looked up in the reflection table (-1 if not active), "name[N]" resolves to name's location + N. Struct
+    //members (e.g. "lights[3].color") are in the table already, no lookup allocates or calls GL
+    GLint uniform_location(const char*) const;
+    GLint uniform_location(hashed_name) const;
+    GLint attribute_location(const char*) const;
+    GLint attribute_location(hashed_name) const;
+
+    //set_uniform calls on the bound program are compared against a CPU shadow of its uniforms
+    //and only reach GL when the value changed
+    struct uniform_counters {
+        std::uint64_t issued;
+        std::uint64_t skipped;
+    };
+    uniform_counters uniform_calls() const;
+    void reset_uniform_calls();
 
     struct bound final {
         bound() = delete;
@@ -196,8 +337,35 @@ public:
     };
     
 private:
+    friend void forget_thread_bindings();
+
     GLuint _id;
+    program_reflection _reflection;
+
+    struct uniform_shadow {
+        //Indexed by location, array elements take consecutive locations
+        struct slot {
+            std::uint32_t offset;
+            //End of the whole uniform (array) the location belongs to
+            std::uint32_t end;
+            //0 = location not shadowed
+            std::uint32_t element_size;
+            bool valid;
+        };
+        std::vector<slot> slots;
+        std::vector<std::byte> data;
+        uniform_counters counters;
+    };
+    uniform_shadow _shadow;
+
+    void build_uniform_shadow();
+    //uniform_location for "name[N]" with N > 0, basic type arrays only register "name[0]" and "name"
+    GLint array_element_location(std::string_view name) const;
+    //true = the bound program already holds these bytes at loc, the call can be skipped
+    static bool shadow_unchanged(GLint loc, const void* data, size_t size, bool transpose = false);
+
     static thread_local GLuint _bound_id;
+    static thread_local program* _bound;
 };
 #ifndef AGL_GL_OBJECT_ACCESS
     #undef glCreateProgram
@@ -207,8 +375,12 @@ private:
 #ifndef AGL_PROGRAM_ACCESS
     #undef glLinkProgram
     #undef glAttachShader
+    #undef glDetachShader
     #undef glGetProgramInfoLog
     #undef glGetUniformLocation
+    #undef glProgramBinary
+    #undef glGetProgramBinary
+    #undef glProgramParameteri
 #endif
 
 struct vertex_array {
@@ -222,12 +394,25 @@ public:
     void bind();
     GLuint id();
 
+    //Separate attribute format/binding state (without direct state access the vertex array is bound to edit)
+    void enable_attrib(GLuint attrib);
+    void disable_attrib(GLuint attrib);
+    void attrib_format(GLuint attrib, GLint size, GLenum type, bool normalized, GLuint relative_offset);
+    void attrib_i_format(GLuint attrib, GLint size, GLenum type, GLuint relative_offset);
+    void attrib_binding(GLuint attrib, GLuint binding);
+    void binding_divisor(GLuint binding, GLuint divisor);
+    void vertex_buffer(GLuint binding, buffer&, GLintptr offset, GLsizei stride);
+    void element_buffer(buffer&);
+
 private:
+    friend void forget_thread_bindings();
+
     GLuint _id;
     static thread_local GLuint _bound_id;
 };
 #ifndef AGL_GL_OBJECT_ACCESS
     #undef glGenVertexArrays
+    #undef glCreateVertexArrays
     #undef glDeleteVertexArrays
     #undef glBindVertexArray
 #endif
@@ -240,6 +425,16 @@ public:
     query(query&&) noexcept;
     ~query();
 
+    void begin(GLenum target);
+    static void end(GLenum target);
+    //Records the GPU time once all previously issued commands complete
+    void timestamp();
+
+    //Non-blocking
+    bool result_available();
+    //Blocks until the result is available, check result_available() first to avoid the stall
+    GLuint64 result();
+
     GLuint id();
 
 private:
@@ -250,6 +445,34 @@ private:
     #undef glDeleteQueries
 #endif
 
+struct fence {
+public:
+    fence(fence&) = delete;
+
+    //Inserts a sync object signaled once all previously issued commands complete
+    fence();
+    fence(fence&&) noexcept;
+    ~fence();
+
+    //Non-blocking, does not flush
+    bool signaled();
+    //true = signaled within timeout, flushes so the fence is guaranteed to signal
+    bool client_wait(GLuint64 timeout_ns);
+    //Blocks until signaled
+    void client_wait();
+    //Makes the GPU wait on the fence without blocking the CPU
+    void server_wait();
+
+    GLsync id();
+
+private:
+    GLsync _sync;
+};
+#ifndef AGL_GL_OBJECT_ACCESS
+    #undef glFenceSync
+    #undef glDeleteSync
+#endif
+
 struct program_pipeline {
 public:
     program_pipeline(program_pipeline&) = delete;
@@ -262,11 +485,14 @@ public:
     GLuint id();
 
 private:
+    friend void forget_thread_bindings();
+
     GLuint _id;
     static thread_local GLuint _bound_id;
 };
 #ifndef AGL_GL_OBJECT_ACCESS
     #undef glGenProgramPipelines
+    #undef glCreateProgramPipelines
     #undef glDeleteProgramPipelines
     #undef glBindProgramPipeline
 #endif
@@ -283,11 +509,14 @@ public:
     GLuint id();
 
 private:
+    friend void forget_thread_bindings();
+
     GLuint _id;
     static thread_local GLuint _bound_id;
 };
 #ifndef AGL_GL_OBJECT_ACCESS
     #undef glGenTransformFeedbacks
+    #undef glCreateTransformFeedbacks
     #undef glDeleteTransformFeedbacks
     #undef glBindTransformFeedback
 #endif
@@ -303,18 +532,76 @@ public:
     void bind(GLuint unit);
     GLuint id();
 
+    //Sampler parameters never require binding
+    void parameter(GLenum pname, GLint value);
+    void parameter(GLenum pname, GLfloat value);
+
 private:
     GLuint _id;
+
+    friend void bind_samplers(GLuint, std::span<sampler* const>);
+    friend void forget_thread_bindings();
+
     static thread_local GLuint _bindings[GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS];
 };
 #ifndef AGL_GL_OBJECT_ACCESS
     #undef glGenSamplers
+    #undef glCreateSamplers
     #undef glDeleteSamplers
     #undef glBindSampler
+    #undef glBindSamplers
 #endif
 
+struct any_texture {
+public:
+    any_texture(any_texture&) = delete;
+
+    ~any_texture();
+
+    //Binds to the active texture unit
+    void bind();
+    void bind(GLuint unit);
+    GLuint id();
+
+    static void active_unit(GLuint unit);
+
+    //Units past this are never cached
+    constexpr static GLuint MAX_CACHED_UNITS = 96;
+    constexpr static size_t TARGET_COUNT = 11;
+    constexpr static size_t target_slot(GLenum target) {
+        switch(target) {
+            case GL_TEXTURE_1D: return 0;
+            case GL_TEXTURE_2D: return 1;
+            case GL_TEXTURE_3D: return 2;
+            case GL_TEXTURE_1D_ARRAY: return 3;
+            case GL_TEXTURE_2D_ARRAY: return 4;
+            case GL_TEXTURE_RECTANGLE: return 5;
+            case GL_TEXTURE_CUBE_MAP: return 6;
+            case GL_TEXTURE_CUBE_MAP_ARRAY: return 7;
+            case GL_TEXTURE_BUFFER: return 8;
+            case GL_TEXTURE_2D_MULTISAMPLE: return 9;
+            case GL_TEXTURE_2D_MULTISAMPLE_ARRAY: return 10;
+            default: return TARGET_COUNT;
+        }
+    }
+
+protected:
+    any_texture(GLenum target);
+    any_texture(any_texture&&) noexcept;
+
+    GLuint _id;
+    GLenum _target;
+
+private:
+    friend void bind_textures(GLuint, std::span<any_texture* const>);
+    friend void forget_thread_bindings();
+
+    static thread_local GLuint _active_unit;
+    static thread_local GLuint _bindings[MAX_CACHED_UNITS][TARGET_COUNT];
+};
+
 template<GLenum TARGET>
-struct texture {
+struct texture : public any_texture {
 
     static_assert(
         TARGET == GL_TEXTURE_1D ||
@@ -336,45 +623,118 @@ struct texture {
 public:
     texture(texture&) = delete;
 
-    texture() {
-        glGenTextures(1, &this->_id);
+    texture() : any_texture(TARGET) {}
+    texture(texture&& move) noexcept : any_texture(std::move(move)) {}
+
+    //Without direct state access these bind the texture to edit
+    void storage(GLsizei levels, GLenum internal_format, GLsizei width) {
+        if(direct_state_access()) {
+            glTextureStorage1D(this->_id, levels, internal_format, width);
+        } else {
+            this->bind();
+            glTexStorage1D(TARGET, levels, internal_format, width);
+        }
     }
-    texture(texture&& move) noexcept
-        : _id(move._id)
-    {
-        move._id = 0;
+    void storage(GLsizei levels, GLenum internal_format, GLsizei width, GLsizei height) {
+        if(direct_state_access()) {
+            glTextureStorage2D(this->_id, levels, internal_format, width, height);
+        } else {
+            this->bind();
+            glTexStorage2D(TARGET, levels, internal_format, width, height);
+        }
     }
-    ~texture() {
-        if(this->_id != 0) {
-            if(_bound_id == this->_id) {
-                _bound_id = 0;
-            }
-            glDeleteTextures(1, &this->_id);
+    void storage(GLsizei levels, GLenum internal_format, GLsizei width, GLsizei height, GLsizei depth) {
+        if(direct_state_access()) {
+            glTextureStorage3D(this->_id, levels, internal_format, width, height, depth);
+        } else {
+            this->bind();
+            glTexStorage3D(TARGET, levels, internal_format, width, height, depth);
         }
     }
-
-    void bind() {
-        if(_bound_id != this->_id) {
-            glBindTexture(TARGET, this->_id);
-            _bound_id = this->_id;
+    //format/type describe data, which is an offset into the bound GL_PIXEL_UNPACK_BUFFER if there is one
+    void sub_image(GLint level, GLint x, GLsizei width, GLenum format, GLenum type, const void* data) {
+        if(direct_state_access()) {
+            glTextureSubImage1D(this->_id, level, x, width, format, type, data);
+        } else {
+            this->bind();
+            glTexSubImage1D(TARGET, level, x, width, format, type, data);
+        }
+    }
+    void sub_image(GLint level, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* data) {
+        if(direct_state_access()) {
+            glTextureSubImage2D(this->_id, level, x, y, width, height, format, type, data);
+        } else {
+            this->bind();
+            glTexSubImage2D(TARGET, level, x, y, width, height, format, type, data);
+        }
+    }
+    void sub_image(GLint level, GLint x, GLint y, GLint z, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void* data) {
+        if(direct_state_access()) {
+            glTextureSubImage3D(this->_id, level, x, y, z, width, height, depth, format, type, data);
+        } else {
+            this->bind();
+            glTexSubImage3D(TARGET, level, x, y, z, width, height, depth, format, type, data);
+        }
+    }
+    //Multisample targets only
+    void storage_multisample(GLsizei samples, GLenum internal_format, GLsizei width, GLsizei height, bool fixed_locations = true) {
+        if(direct_state_access()) {
+            glTextureStorage2DMultisample(this->_id, samples, internal_format, width, height, fixed_locations);
+        } else {
+            this->bind();
+            glTexStorage2DMultisample(TARGET, samples, internal_format, width, height, fixed_locations);
+        }
+    }
+    void storage_multisample(GLsizei samples, GLenum internal_format, GLsizei width, GLsizei height, GLsizei depth, bool fixed_locations = true) {
+        if(direct_state_access()) {
+            glTextureStorage3DMultisample(this->_id, samples, internal_format, width, height, depth, fixed_locations);
+        } else {
+            this->bind();
+            glTexStorage3DMultisample(TARGET, samples, internal_format, width, height, depth, fixed_locations);
         }
     }
-    GLuint id() {
-        return this->_id;
+    void generate_mipmap() {
+        if(direct_state_access()) {
+            glGenerateTextureMipmap(this->_id);
+        } else {
+            this->bind();
+            glGenerateMipmap(TARGET);
+        }
+    }
+    void parameter(GLenum pname, GLint value) {
+        if(direct_state_access()) {
+            glTextureParameteri(this->_id, pname, value);
+        } else {
+            this->bind();
+            glTexParameteri(TARGET, pname, value);
+        }
+    }
+    void parameter(GLenum pname, GLfloat value) {
+        if(direct_state_access()) {
+            glTextureParameterf(this->_id, pname, value);
+        } else {
+            this->bind();
+            glTexParameterf(TARGET, pname, value);
+        }
     }
 
     constexpr static GLenum target = TARGET;
-
-private:
-    GLuint _id;
-    static thread_local GLuint _bound_id;
 };
 #ifndef AGL_GL_OBJECT_ACCESS
     #undef glGenTextures
+    #undef glCreateTextures
     #undef glDeleteTextures
     #undef glBindTexture
+    #undef glBindTextures
+    #undef glActiveTexture
 #endif
 
+//Binds textures[i] to unit first_unit + i (nullptr unbinds every target of that unit),
+//only units whose binding changed are submitted, in a single glBindTextures call when multi-bind is available
+void bind_textures(GLuint first_unit, std::span<any_texture* const> textures);
+//Same as bind_textures but for samplers (nullptr unbinds)
+void bind_samplers(GLuint first_unit, std::span<sampler* const> samplers);
+
 using texture_1d = texture<GL_TEXTURE_1D>; 
 using texture_2d = texture<GL_TEXTURE_2D>;
 using texture_3d = texture<GL_TEXTURE_3D>;
@@ -398,12 +758,19 @@ public:
     void bind();
     GLuint id();
 
+    //Without direct state access these bind the renderbuffer to edit
+    void storage(GLenum internal_format, GLsizei width, GLsizei height);
+    void storage_multisample(GLsizei samples, GLenum internal_format, GLsizei width, GLsizei height);
+
 private:
+    friend void forget_thread_bindings();
+
     GLuint _id;
     static thread_local GLuint _bound_id;
 };
 #ifndef AGL_GL_OBJECT_ACCESS
     #undef glGenRenderbuffers
+    #undef glCreateRenderbuffers
     #undef glDeleteRenderbuffers
     #undef glBindRenderbuffer
 #endif
@@ -422,9 +789,24 @@ public:
     void bind_write();
     GLuint id();
 
+    //Without direct state access these bind the framebuffer (read and draw) to edit
+    void attach(GLenum attachment, any_texture&, GLint level = 0);
+    //One layer of an array, cube map or 3D texture
+    void attach_layer(GLenum attachment, any_texture&, GLint level, GLint layer);
+    void attach(GLenum attachment, renderbuffer&);
+    void detach(GLenum attachment);
+    void draw_buffers(std::span<const GLenum> attachments);
+    void read_buffer(GLenum attachment);
+    //GL_FRAMEBUFFER_COMPLETE or the reason it is not
+    GLenum status();
+    //Contents of attachments become undefined, lets the driver skip storing (or loading) them
+    void invalidate(std::span<const GLenum> attachments);
+
     static thread_local framebuffer DEFAULT;
 
 private:
+    friend void forget_thread_bindings();
+
     GLuint _id;
 
     framebuffer(GLuint id);
@@ -434,6 +816,7 @@ private:
 };
 #ifndef AGL_GL_OBJECT_ACCESS
     #undef glGenFramebuffers
+    #undef glCreateFramebuffers
     #undef glDeleteFramebuffers
     #undef glBindFramebuffer
 #endif
@@ -0,0 +1,107 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_PROFILER_HPP
+#define AGL_PROFILER_HPP
+
+#include<vector>
+#include<deque>
+#include<ostream>
+#include<cstdint>
+
+#include "agl/opengl.hpp"
+#include "agl/objects.hpp"
+
+namespace agl
+{
+
+//GPU pass timings from GL_TIMESTAMP queries, read back latency frames later so reading never stalls
+struct gpu_profiler {
+public:
+    struct zone {
+        //Zone names must outlive the profiler (string literals)
+        const char* name;
+        GLuint depth;
+        //-1 for the frame's root zone
+        GLint parent;
+        GLuint64 begin_ns;
+        GLuint64 end_ns;
+
+        double milliseconds() const {return double(end_ns - begin_ns) / 1000000.0;}
+    };
+    struct frame {
+        std::uint64_t index;
+        //Pre-order, zones[0] is the whole frame
+        std::vector<zone> zones;
+    };
+
+    gpu_profiler(gpu_profiler&) = delete;
+
+    gpu_profiler(GLuint latency = 3, GLuint max_zones_per_frame = 256, size_t history_size = 120);
+    gpu_profiler(gpu_profiler&&) noexcept = default;
+
+    void begin_frame();
+    void end_frame();
+
+    void begin_zone(const char* name);
+    void end_zone();
+
+    //Most recently resolved frame, nullptr until one is available
+    frame const* latest() const;
+    std::deque<frame> const& history() const;
+    //Frames whose queries were still pending when their slot had to be reused
+    std::uint64_t dropped_frames() const;
+
+    //Chrome trace event format, viewable in chrome://tracing or Perfetto
+    void write_chrome_trace(std::ostream&) const;
+
+private:
+    struct pending_zone {
+        const char* name;
+        GLuint depth;
+        GLint parent;
+        GLuint begin_query;
+        GLuint end_query;
+    };
+    struct frame_slot {
+        std::vector<query> queries;
+        std::vector<pending_zone> zones;
+        GLuint used_queries;
+        std::uint64_t index;
+        bool pending;
+    };
+
+    GLuint next_query(frame_slot&);
+    void resolve(frame_slot&);
+
+    std::vector<frame_slot> _slots;
+    GLuint _max_zones;
+    size_t _history_size;
+    std::deque<frame> _history;
+
+    std::vector<GLint> _open_zones;
+    std::uint64_t _frame;
+    std::uint64_t _dropped_frames;
+    bool _recording;
+};
+
+//Scoped gpu_profiler zone
+struct gpu_zone {
+public:
+    gpu_zone(gpu_zone&) = delete;
+
+    gpu_zone(gpu_profiler& profiler, const char* name)
+        : _profiler(profiler)
+    {
+        this->_profiler.begin_zone(name);
+    }
+    ~gpu_zone() {
+        this->_profiler.end_zone();
+    }
+
+private:
+    gpu_profiler& _profiler;
+};
+
+}
+
+#endif //AGL_PROFILER_HPP
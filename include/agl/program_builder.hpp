@@ -0,0 +1,76 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_PROGRAM_BUILDER_HPP
+#define AGL_PROGRAM_BUILDER_HPP
+
+#include<string>
+#include<string_view>
+#include<span>
+#include<vector>
+#include<memory>
+#include<cstddef>
+
+#include "agl/opengl.hpp"
+#include "agl/objects.hpp"
+
+namespace agl
+{
+
+struct program_build;
+
+//Handle to a program_builder submission, status() only reads state resolved by program_builder::poll
+//and never calls into GL
+struct program_future {
+public:
+    enum class state {
+        pending,
+        linked,
+        failed
+    };
+
+    program_future() = default;
+
+    //false for a default constructed future
+    bool valid() const;
+    state status() const;
+    //true once linked or failed
+    bool ready() const;
+
+    //The program being built, only usable once status() == state::linked
+    program& get();
+    //Shader and program logs of a failed build
+    std::string const& info_log() const;
+
+private:
+    friend struct program_builder;
+    std::shared_ptr<program_build> _build;
+};
+
+//Submits every compile and link up front and resolves them later, so the driver can build in the
+//background (KHR_parallel_shader_compile) while the render thread keeps drawing
+struct program_builder {
+public:
+    program_builder(program_builder&) = delete;
+
+    //max_threads is passed to glMaxShaderCompilerThreadsKHR (0xFFFFFFFF = driver's choice)
+    explicit program_builder(GLuint max_threads = 0xFFFFFFFF);
+    program_builder(program_builder&&) noexcept;
+    //Waits for outstanding builds so their futures resolve
+    ~program_builder();
+
+    //Issues glCompileShader for every stage and glLinkProgram without querying any status
+    program_future submit(std::span<const shader_source> sources, std::string_view defines = {});
+
+    //Resolves finished builds and returns how many resolved. With parallel_shader_compile() only
+    //completed builds are touched (never blocks), otherwise at most blocking_budget builds are waited on
+    size_t poll(size_t blocking_budget = 1);
+    void finish_all();
+    size_t pending() const;
+
+private:
+    std::vector<std::shared_ptr<program_build>> _pending;
+};
+
+}
+
+#endif //AGL_PROGRAM_BUILDER_HPP
@@ -0,0 +1,80 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_PROGRAM_CACHE_HPP
+#define AGL_PROGRAM_CACHE_HPP
+
+#include<string>
+#include<string_view>
+#include<span>
+#include<vector>
+#include<unordered_map>
+#include<cstddef>
+#include<cstdint>
+
+#include "agl/opengl.hpp"
+#include "agl/objects.hpp"
+
+namespace agl
+{
+
+//Linked program binaries keyed by a hash of the shader sources, defines, GL_RENDERER and GL_VERSION,
+//persisted to a memory-mapped archive file so later runs skip compiling and linking from GLSL
+//(construct with a current context, binaries are only valid for the driver that produced them)
+struct program_cache {
+public:
+    struct statistics {
+        std::uint64_t hits;
+        std::uint64_t misses;
+        //Binaries the driver refused (format mismatch), these fall back to source
+        std::uint64_t rejected;
+    };
+
+    program_cache(program_cache&) = delete;
+
+    explicit program_cache(std::string path);
+    program_cache(program_cache&&) noexcept;
+    //Saves any new binaries
+    ~program_cache();
+
+    //Links prog from the archive if possible, otherwise compiles sources and stores the result,
+    //defines are inserted after each source's #version line, true = linked
+    bool link(program& prog, std::span<const shader_source> sources, std::string_view defines = {});
+
+    //Rewrites the archive if binaries were added, true = success or nothing to write
+    bool save();
+    //Drops every entry, the archive is emptied on the next save
+    void clear();
+
+    statistics stats() const;
+    size_t entry_count() const;
+    //false if the driver exposes no program binary formats, link() then always compiles
+    bool binaries_supported() const;
+
+private:
+    struct record {
+        GLenum format;
+        //Points into the mapped archive, or into owned for binaries added this run
+        std::span<const std::byte> binary;
+        std::vector<std::byte> owned;
+    };
+
+    std::uint64_t key(std::span<const shader_source> sources, std::string_view defines) const;
+    bool link_from_source(program& prog, std::span<const shader_source> sources, std::string_view defines);
+    void map_archive();
+    void unmap_archive();
+
+    std::string _path;
+    std::string _driver;
+    bool _binaries_supported;
+    bool _dirty;
+
+    const std::byte* _mapping;
+    size_t _mapping_size;
+
+    std::unordered_map<std::uint64_t, record> _records;
+    statistics _stats;
+};
+
+}
+
+#endif //AGL_PROGRAM_CACHE_HPP
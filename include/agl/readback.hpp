@@ -0,0 +1,109 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_READBACK_HPP
+#define AGL_READBACK_HPP
+
+#include<vector>
+#include<optional>
+#include<span>
+#include<chrono>
+#include<cstddef>
+#include<cstdint>
+
+#include "agl/opengl.hpp"
+#include "agl/objects.hpp"
+
+namespace agl
+{
+
+//Bytes per pixel of a glReadPixels/glTexSubImage format and type pair, 0 if unsupported
+GLsizei pixel_size(GLenum format, GLenum type);
+
+//Asynchronous glReadPixels into a ring of persistently mapped GL_PIXEL_PACK_BUFFER buffers,
+//each readback is fenced and handed back a few frames later as a span over the mapping (no copy)
+struct readback_queue {
+public:
+    struct frame {
+        //Rows bottom to top, each row_pitch bytes apart (GL_PACK_ALIGNMENT at request time)
+        std::span<const std::byte> pixels;
+        GLsizei row_pitch;
+        GLsizei width;
+        GLsizei height;
+        //Request order, starting at 0
+        std::uint64_t sequence;
+        //Request to the readback being handed out
+        double latency;
+        //Identifies the pack buffer for release
+        size_t slot;
+    };
+
+    struct statistics {
+        std::uint64_t requested;
+        std::uint64_t completed;
+        //Requests refused because every pack buffer was still pending or not yet released
+        std::uint64_t dropped;
+        std::uint64_t bytes;
+        //First request to the latest completion
+        double elapsed;
+        double total_latency;
+        double max_latency;
+
+        double megabytes_per_second() const;
+        double average_latency() const;
+    };
+
+    readback_queue(readback_queue&) = delete;
+
+    //max_frame_size bytes per pack buffer, depth pack buffers
+    readback_queue(GLsizeiptr max_frame_size, size_t depth = 3);
+    readback_queue(readback_queue&&) noexcept;
+    ~readback_queue();
+
+    //Reads from fb's read buffer into the next free pack buffer without waiting for the GPU,
+    //false if the region is too large or no pack buffer is free (the frame is dropped)
+    bool request(framebuffer& fb, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type);
+    //Oldest readback if its fence signaled, never blocks
+    std::optional<frame> poll();
+    //Oldest readback, blocking until it completes (nullopt if none are pending)
+    std::optional<frame> wait();
+    //The frame's span is invalid afterwards and its pack buffer can take the next request
+    void release(frame const&);
+
+    //Requested but not handed out yet
+    size_t pending() const;
+    statistics stats() const;
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    enum class slot_state {
+        free,
+        pending,
+        acquired
+    };
+    struct slot {
+        single_binding_buffer<GL_PIXEL_PACK_BUFFER> buffer;
+        const std::byte* mapping;
+        slot_state state;
+        std::optional<fence> done;
+        frame info;
+        clock::time_point requested;
+    };
+
+    std::optional<frame> take_oldest(bool wait);
+
+    std::vector<slot> _slots;
+    GLsizeiptr _max_frame_size;
+    //Next slot to request into, the oldest pending slot
+    size_t _next;
+    size_t _oldest;
+    size_t _pending;
+    std::uint64_t _sequence;
+
+    clock::time_point _first_request;
+    statistics _stats;
+};
+
+}
+
+#endif //AGL_READBACK_HPP
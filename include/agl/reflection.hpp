@@ -0,0 +1,115 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_REFLECTION_HPP
+#define AGL_REFLECTION_HPP
+
+#include<vector>
+#include<string>
+#include<string_view>
+#include<cstdint>
+
+#include "agl/opengl.hpp"
+
+namespace agl
+{
+
+//FNV-1a, names are identified by hash alone (collisions between a program's names are not handled)
+constexpr std::uint64_t hash_name(std::string_view name) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for(char c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+struct hashed_name {
+    std::uint64_t hash;
+};
+
+namespace literals {
+    //"model"_name hashes at compile time
+    consteval hashed_name operator""_name(const char* name, size_t length) {
+        return {hash_name(std::string_view(name, length))};
+    }
+}
+
+//Tightly packed client side size in bytes of a GLSL type enum (GL_FLOAT_VEC3 = 12),
+//samplers and images count as a GLint, 0 for unknown types
+size_t glsl_type_size(GLenum type);
+
+//Active resources of a linked program, looked up by name hash without calling into GL
+struct program_reflection {
+public:
+    struct uniform {
+        std::uint64_t hash;
+        size_t name_offset;
+        GLenum type;
+        GLint array_size;
+        //-1 for block members
+        GLint location;
+        //-1 for the default block
+        GLint block_index;
+        GLint offset;
+    };
+    struct block {
+        std::uint64_t hash;
+        size_t name_offset;
+        //GL_UNIFORM_BLOCK or GL_SHADER_STORAGE_BLOCK
+        GLenum interface;
+        GLuint index;
+        GLint binding;
+        GLint data_size;
+    };
+    struct attribute {
+        std::uint64_t hash;
+        size_t name_offset;
+        GLenum type;
+        GLint array_size;
+        GLint location;
+    };
+
+    //Through the program interface queries with GL 4.3 or ARB_program_interface_query, otherwise through
+    //glGetActiveUniform/glGetActiveAttrib (shader storage blocks are then not listed)
+    void reflect(GLuint program);
+    void clear();
+
+    //nullptr if not active
+    uniform const* find_uniform(std::uint64_t hash) const;
+    block const* find_block(std::uint64_t hash) const;
+    attribute const* find_attribute(std::uint64_t hash) const;
+
+    std::vector<uniform> const& uniforms() const;
+    std::vector<block> const& blocks() const;
+    std::vector<attribute> const& attributes() const;
+    const char* name(size_t name_offset) const;
+
+private:
+    //Open addressing over the entry vectors, slots hold entry index + 1 (0 = empty)
+    struct table {
+        std::vector<std::uint32_t> slots;
+
+        template<typename ENTRY>
+        void build(std::vector<ENTRY> const& entries);
+        template<typename ENTRY>
+        ENTRY const* find(std::vector<ENTRY> const& entries, std::uint64_t hash) const;
+    };
+
+    void reflect_resources(GLuint program);
+    void reflect_active(GLuint program);
+    template<typename ENTRY>
+    void add(std::vector<ENTRY>& entries, std::string_view name, ENTRY entry, bool array_alias);
+
+    std::vector<uniform> _uniforms;
+    std::vector<block> _blocks;
+    std::vector<attribute> _attributes;
+    std::string _names;
+
+    table _uniform_table;
+    table _block_table;
+    table _attribute_table;
+};
+
+}
+
+#endif //AGL_REFLECTION_HPP
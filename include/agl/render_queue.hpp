@@ -0,0 +1,90 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_RENDER_QUEUE_HPP
+#define AGL_RENDER_QUEUE_HPP
+
+#include<vector>
+#include<span>
+#include<cstddef>
+#include<cstdint>
+
+#include "agl/opengl.hpp"
+#include "agl/objects.hpp"
+#include "agl/arena.hpp"
+
+namespace agl
+{
+
+struct render_command {
+    program* prog;
+    vertex_array* vao;
+    //Bound to units 0..n-1, the span is copied when the command is recorded
+    std::span<any_texture* const> textures;
+    GLenum mode;
+    //0 draws arrays
+    GLenum index_type;
+    GLsizei count;
+    //First index (elements) or first vertex (arrays)
+    GLuint first;
+    GLint base_vertex = 0;
+    GLsizei instance_count = 1;
+    GLuint base_instance = 0;
+    //Called after the command's state is bound, for per-draw uniforms
+    void (*setup)(void const* user) = nullptr;
+    void const* user = nullptr;
+};
+
+//Records draws with 64 bit sort keys and replays them in key order so draws sharing state run together
+//Key bits, most significant first: pass (6), program (12), vertex array (12), material (12), depth (22)
+struct render_queue {
+public:
+    struct statistics {
+        std::uint64_t commands;
+        //Program, vertex array and texture unit changes while replaying in key order
+        std::uint64_t state_changes;
+        //Changes the same commands would have caused in submission order
+        std::uint64_t submission_order_state_changes;
+
+        std::uint64_t avoided_state_changes() const;
+    };
+
+    //Object ids are truncated to their field, a collision only costs state changes.
+    //depth is clamped to [0, 1] and sorts front to back, pass 1 - depth for back to front
+    static std::uint64_t make_key(std::uint32_t pass, GLuint program, GLuint vertex_array, std::uint32_t material, float depth);
+
+    render_queue(render_queue&) = delete;
+
+    explicit render_queue(size_t arena_block_size = 64 * 1024);
+    render_queue(render_queue&&) noexcept = default;
+
+    //Objects referenced by the command must outlive flush
+    void submit(std::uint32_t pass, std::uint32_t material, float depth, render_command const&);
+    void submit(std::uint64_t key, render_command const&);
+    //Sorts, replays and clears the recorded commands
+    void flush();
+    //Drops the recorded commands without drawing
+    void clear();
+    size_t size() const;
+
+    statistics stats() const;
+    void reset_stats();
+
+private:
+    struct entry {
+        std::uint64_t key;
+        render_command const* command;
+    };
+
+    static std::uint64_t count_state_changes(std::span<const entry>);
+    static void replay(render_command const&);
+    void radix_sort();
+
+    arena _arena;
+    std::vector<entry> _entries;
+    std::vector<entry> _scratch;
+    statistics _stats;
+};
+
+}
+
+#endif //AGL_RENDER_QUEUE_HPP
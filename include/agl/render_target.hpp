@@ -0,0 +1,139 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_RENDER_TARGET_HPP
+#define AGL_RENDER_TARGET_HPP
+
+#include<vector>
+#include<memory>
+#include<variant>
+#include<span>
+#include<cstddef>
+#include<cstdint>
+
+#include "agl/opengl.hpp"
+#include "agl/objects.hpp"
+
+namespace agl
+{
+
+//Framebuffer whose completeness was checked once when it was built
+struct render_target {
+public:
+    render_target(render_target&) = delete;
+    render_target(render_target&&) noexcept = default;
+
+    void bind();
+    //Discards the attachments built as discardable, call once the pass is done with them
+    void invalidate();
+    //Discards every attachment, before a pass that overwrites all of them
+    void invalidate_all();
+
+    bool complete() const;
+    GLenum status() const;
+    //nullptr if nothing or a renderbuffer is attached there
+    any_texture* texture(GLenum attachment) const;
+    framebuffer& get_framebuffer();
+
+private:
+    friend struct framebuffer_builder;
+    render_target() = default;
+
+    struct attachment_info {
+        GLenum attachment;
+        any_texture* texture;
+    };
+
+    framebuffer _framebuffer;
+    std::vector<attachment_info> _attachments;
+    std::vector<GLenum> _all;
+    std::vector<GLenum> _discardable;
+    GLenum _status = GL_FRAMEBUFFER_UNDEFINED;
+};
+
+//Attaches textures and renderbuffers (which must outlive the render_target) and builds a render_target:
+//  agl::render_target target = agl::framebuffer_builder()
+//      .color(0, hdr_color)
+//      .attach(GL_DEPTH_ATTACHMENT, depth, true)
+//      .build();
+struct framebuffer_builder {
+public:
+    framebuffer_builder& attach(GLenum attachment, any_texture&, GLint level = 0, bool discardable = false);
+    framebuffer_builder& attach(GLenum attachment, renderbuffer&, bool discardable = false);
+    framebuffer_builder& color(GLuint index, any_texture&, GLint level = 0, bool discardable = false);
+    framebuffer_builder& color(GLuint index, renderbuffer&, bool discardable = false);
+
+    //Draws to the color attachments in index order and checks completeness (reported in debug builds)
+    render_target build();
+
+private:
+    void add(GLenum attachment, any_texture*, bool discardable);
+
+    render_target _target;
+};
+
+struct transient_attachment {
+    GLenum attachment;
+    GLenum internal_format;
+    //Contents are not needed once the pass is done (see render_target::invalidate)
+    bool discardable = false;
+};
+
+//Render targets for per-frame passes, attachments are pooled textures keyed by (format, size, samples)
+//and reused across passes and frames instead of being reallocated, framebuffers are cached per texture set
+struct render_target_pool {
+public:
+    struct statistics {
+        size_t textures;
+        size_t targets;
+        std::uint64_t texture_allocations;
+        std::uint64_t texture_reuses;
+        std::uint64_t target_builds;
+        std::uint64_t target_reuses;
+    };
+
+    render_target_pool(render_target_pool&) = delete;
+
+    //Pooled textures and targets unused for max_idle_frames end_frame calls are freed
+    explicit render_target_pool(std::uint32_t max_idle_frames = 3);
+    render_target_pool(render_target_pool&&) noexcept = default;
+
+    //Attachments are 2D textures (multisample if samples > 0) whose contents are undefined (invalidated),
+    //the target stays valid until it is released or the frame ends
+    render_target& acquire(GLsizei width, GLsizei height, GLsizei samples, std::span<const transient_attachment>);
+    //Returns the target's textures to the pool early, once every pass reading them was issued
+    void release(render_target&);
+    //Releases every target and frees idle textures and targets
+    void end_frame();
+
+    statistics stats() const;
+
+private:
+    struct pooled_texture {
+        GLenum internal_format;
+        GLsizei width;
+        GLsizei height;
+        GLsizei samples;
+        std::variant<texture_2d, multisample_texture_2d> texture;
+        bool in_use;
+        std::uint64_t last_used;
+
+        any_texture& get();
+    };
+    struct cached_target {
+        std::vector<std::pair<GLenum, pooled_texture*>> key;
+        render_target target;
+        std::uint64_t last_used;
+    };
+
+    pooled_texture& acquire_texture(GLenum internal_format, GLsizei width, GLsizei height, GLsizei samples);
+
+    std::vector<std::unique_ptr<pooled_texture>> _textures;
+    std::vector<std::unique_ptr<cached_target>> _targets;
+    std::uint32_t _max_idle_frames;
+    std::uint64_t _frame;
+    statistics _stats;
+};
+
+}
+
+#endif //AGL_RENDER_TARGET_HPP
@@ -0,0 +1,129 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_RESOURCE_LOADER_HPP
+#define AGL_RESOURCE_LOADER_HPP
+
+#include<vector>
+#include<deque>
+#include<memory>
+#include<optional>
+#include<thread>
+#include<mutex>
+#include<condition_variable>
+#include<type_traits>
+#include<utility>
+#include<cstddef>
+
+#include "agl/opengl.hpp"
+#include "agl/objects.hpp"
+#include "agl/context_util.hpp"
+
+namespace agl
+{
+
+//A resource_loader job, run() creates the resource on a worker
+struct loader_job {
+    virtual ~loader_job() = default;
+    virtual void run() = 0;
+
+    //Inserted and flushed by the worker after run(), publication waits on it
+    std::optional<fence> completion;
+    //Render thread only
+    bool published = false;
+};
+
+template<typename T>
+struct loader_result : public loader_job {
+    std::optional<T> value;
+};
+
+template<typename T>
+struct resource_future {
+public:
+    resource_future() = default;
+
+    bool valid() const {
+        return this->_result != nullptr;
+    }
+    //true once resource_loader::publish saw the worker's commands complete,
+    //the resource may then be used (bound) on the render thread
+    bool ready() const {
+        return this->_result->published;
+    }
+    T& get() {
+        return *this->_result->value;
+    }
+
+private:
+    friend struct resource_loader;
+    std::shared_ptr<loader_result<T>> _result;
+};
+
+//Worker threads with contexts sharing objects with the render thread's, jobs create and fill buffers and
+//textures off the render thread and are published to it once their fence signals.
+//Objects created by a job are only guaranteed up to date on the render thread after it binds them
+struct resource_loader {
+public:
+    resource_loader(resource_loader&) = delete;
+    resource_loader(resource_loader&&) = delete;
+
+    //Call on the render thread with its context current, contexts come from the registered context_factory,
+    //without one (or if every context fails) jobs run on the render thread inside submit
+    explicit resource_loader(size_t worker_count = 1);
+    resource_loader(size_t worker_count, context_factory const&);
+    //Runs the queued jobs, then joins the workers and destroys their contexts
+    ~resource_loader();
+
+    //fn runs on a worker with its context current and returns the resource it created (e.g. a texture_2d)
+    template<typename FN>
+    auto submit(FN&& fn) {
+        using T = std::invoke_result_t<std::decay_t<FN>&>;
+        static_assert(!std::is_void_v<T>, "resource_loader jobs must return the resource they create!");
+
+        struct task final : public loader_result<T> {
+            std::decay_t<FN> fn;
+
+            explicit task(FN&& f) : fn(std::forward<FN>(f)) {}
+            void run() override {
+                this->value.emplace(this->fn());
+            }
+        };
+
+        auto job = std::make_shared<task>(std::forward<FN>(fn));
+        resource_future<T> future;
+        future._result = job;
+        this->enqueue(std::move(job));
+        return future;
+    }
+
+    //Render thread, once per frame: publishes finished jobs whose fence signaled, never blocks,
+    //returns how many were published
+    size_t publish();
+    //Submitted but not yet published
+    size_t pending() const;
+    size_t worker_count() const;
+
+private:
+    void start(size_t worker_count);
+    void enqueue(std::shared_ptr<loader_job>);
+    void worker_main();
+
+    std::optional<context_factory> _factory;
+    std::vector<std::thread> _workers;
+    std::vector<void*> _contexts;
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::deque<std::shared_ptr<loader_job>> _queue;
+    //Handed from the workers to the render thread under _mutex
+    std::vector<std::shared_ptr<loader_job>> _completed;
+    bool _stopping;
+
+    //Render thread only
+    std::vector<std::shared_ptr<loader_job>> _unpublished;
+    size_t _pending;
+};
+
+}
+
+#endif //AGL_RESOURCE_LOADER_HPP
@@ -0,0 +1,74 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_STREAMING_BUFFER_HPP
+#define AGL_STREAMING_BUFFER_HPP
+
+#include<vector>
+#include<optional>
+#include<cstddef>
+#include<cstring>
+
+#include "agl/opengl.hpp"
+#include "agl/objects.hpp"
+
+namespace agl
+{
+
+//Persistently and coherently mapped buffer split into frame_count regions,
+//each region is fenced once its frame is submitted and only rewritten after the GPU retires it
+struct streaming_buffer {
+public:
+    struct allocation {
+        void* data;
+        GLintptr offset;
+        GLsizeiptr size;
+
+        explicit operator bool() const {return data != nullptr;}
+    };
+
+    streaming_buffer(streaming_buffer&) = delete;
+
+    //frame_count is at least 1
+    streaming_buffer(GLsizeiptr frame_size, GLuint frame_count = 3);
+    streaming_buffer(streaming_buffer&&) noexcept;
+    ~streaming_buffer();
+
+    //Returns an empty allocation if the current frame's region is exhausted
+    allocation allocate(GLsizeiptr size, GLsizeiptr alignment = 1);
+
+    template<typename T>
+    allocation push(T const* values, size_t count, GLsizeiptr alignment = alignof(T)) {
+        allocation alloc = this->allocate(sizeof(T) * count, alignment);
+        if(alloc) {
+            std::memcpy(alloc.data, values, sizeof(T) * count);
+        }
+        return alloc;
+    }
+
+    //Fences the current region and moves on to the next, waiting if the GPU still uses it.
+    //Does nothing on a moved from (or unmapped) buffer
+    void next_frame();
+
+    void bind(GLenum target);
+    void bind_range(GLenum target, GLuint index, allocation const&);
+    GLuint id();
+
+    GLsizeiptr frame_size() const;
+    GLuint frame_count() const;
+    GLuint frame_index() const;
+
+private:
+    buffer _buffer;
+    std::byte* _mapping;
+
+    GLsizeiptr _frame_size;
+    GLuint _frame_count;
+    GLuint _frame;
+    GLsizeiptr _head;
+
+    std::vector<std::optional<fence>> _fences;
+};
+
+}
+
+#endif //AGL_STREAMING_BUFFER_HPP
@@ -0,0 +1,126 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_TEXTURE_TABLE_HPP
+#define AGL_TEXTURE_TABLE_HPP
+
+#include<list>
+#include<vector>
+#include<unordered_map>
+#include<optional>
+#include<string_view>
+#include<cstddef>
+#include<cstdint>
+
+#include "agl/opengl.hpp"
+#include "agl/objects.hpp"
+
+namespace agl
+{
+
+//2D textures addressed by index from shaders, so draws with different materials need no texture binds.
+//With bindless_texture() the table is a storage buffer of 64-bit ARB_bindless_texture handles, kept resident
+//for the textures used in the last frames and evicted least recently used past max_resident. Otherwise the textures
+//are copied into the layers of one texture array (they must then match its format, size and level count).
+//Shaders compile with defines() and read the table like this:
+//  #ifdef AGL_TEXTURE_TABLE_BINDLESS
+//  #extension GL_ARB_bindless_texture : require
+//  layout(std430, binding = 0) readonly buffer texture_table {uvec2 handles[];};
+//  vec4 table_texture(uint index, vec2 uv) {return texture(sampler2D(handles[index]), uv);}
+//  #else
+//  layout(binding = 0) uniform sampler2DArray texture_table;
+//  vec4 table_texture(uint index, vec2 uv) {return texture(texture_table, vec3(uv, index));}
+//  #endif
+struct texture_table {
+public:
+    struct statistics {
+        std::uint64_t resident;
+        std::uint64_t made_resident;
+        std::uint64_t made_non_resident;
+        //Made non-resident because max_resident was reached
+        std::uint64_t evictions;
+        //Entries resident past max_resident because all of them were used this frame
+        std::uint64_t over_budget;
+    };
+
+    constexpr static GLuint NO_INDEX = ~GLuint(0);
+
+    texture_table(texture_table&) = delete;
+    texture_table(texture_table&&) = delete;
+
+    //Room for capacity textures, the fallback array is allocated with levels x width x height x capacity
+    //of fallback_format
+    texture_table(GLuint capacity, GLuint max_resident,
+                  GLenum fallback_format, GLsizei width, GLsizei height, GLsizei levels = 1);
+    //Makes every handle non-resident
+    ~texture_table();
+
+    //false = texture array fallback
+    bool bindless() const;
+    //"#define AGL_TEXTURE_TABLE_BINDLESS\n" on the bindless path, for any_shader::compile(source, defines)
+    std::string_view defines() const;
+
+    //Index of the texture in the table, NO_INDEX once capacity is reached. Bindless handles fix the texture's
+    //(or sampler's, if given) parameters and the texture must outlive its entry, the fallback copies the
+    //texture's current contents. Adding a texture and sampler pair already in the table (bindless) returns
+    //its index again
+    GLuint add(texture_2d& texture, sampler* with = nullptr);
+    //Once per add, the index may be reused by the next add after the last remove
+    void remove(GLuint index);
+    //Call for each entry a frame's draws read, before they are issued, makes it resident
+    void use(GLuint index);
+
+    //Uploads changed handles and binds the table to storage_index (bindless) or the array to unit (fallback)
+    void bind(GLuint storage_index, GLuint unit);
+    //Entries not used since become candidates for eviction
+    void end_frame();
+
+    //nullptr on the bindless path, e.g. to change the array's filtering (linear by default)
+    array_texture_2d* fallback_array();
+
+    GLuint size() const;
+    statistics stats() const;
+
+private:
+    struct entry {
+        GLuint64 handle;
+        std::uint64_t last_used;
+        //adds not yet removed
+        GLuint references;
+        bool resident;
+        std::list<GLuint>::iterator lru;
+    };
+
+    void make_resident(GLuint index);
+    void make_non_resident(GLuint index);
+
+    bool _bindless;
+    GLuint _capacity;
+    GLuint _max_resident;
+    GLsizei _width;
+    GLsizei _height;
+    GLsizei _levels;
+
+    std::vector<entry> _entries;
+    std::vector<GLuint> _free;
+    GLuint _size;
+    //Bindless: index of each handle in the table
+    std::unordered_map<GLuint64, GLuint> _indices;
+    //Resident entries, most recently used first
+    std::list<GLuint> _lru;
+    GLuint _resident;
+    std::uint64_t _frame;
+
+    //Bindless: handles mirrored on the CPU, uploaded from _dirty_begin to _dirty_end on bind
+    std::vector<GLuint64> _handles;
+    std::optional<buffer> _handle_buffer;
+    size_t _dirty_begin;
+    size_t _dirty_end;
+    //Fallback
+    std::optional<array_texture_2d> _array;
+
+    statistics _stats;
+};
+
+}
+
+#endif //AGL_TEXTURE_TABLE_HPP
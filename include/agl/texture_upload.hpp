@@ -0,0 +1,111 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_TEXTURE_UPLOAD_HPP
+#define AGL_TEXTURE_UPLOAD_HPP
+
+#include<vector>
+#include<optional>
+#include<span>
+#include<chrono>
+#include<cstddef>
+#include<cstdint>
+
+#include "agl/opengl.hpp"
+#include "agl/objects.hpp"
+
+namespace agl
+{
+
+//Uploads texture data through a ring of persistently mapped GL_PIXEL_UNPACK_BUFFER staging buffers,
+//pixels are copied into the mapping and the GPU reads them on its own timeline, so sub_image returns
+//without the driver copying (or waiting on) client memory. Each level or layer is its own upload
+struct texture_upload_pool {
+public:
+    struct statistics {
+        std::uint64_t uploads;
+        //Larger than a staging buffer, sent straight from client memory
+        std::uint64_t direct_uploads;
+        std::uint64_t bytes;
+        //Inside upload calls (copies and GL calls)
+        double cpu_seconds;
+        //Part of cpu_seconds spent waiting for a staging buffer the GPU was still reading
+        double stall_seconds;
+
+        //First upload into a staging buffer to its fence being seen signaled (by flush or a stall)
+        std::uint64_t completed_batches;
+        double last_latency;
+        double max_latency;
+        double total_latency;
+
+        //Bytes per second of cpu_seconds
+        double throughput() const;
+        double average_latency() const;
+    };
+
+    texture_upload_pool(texture_upload_pool&) = delete;
+
+    texture_upload_pool(GLsizeiptr staging_size = 8 << 20, size_t staging_count = 4);
+    texture_upload_pool(texture_upload_pool&&) noexcept;
+    ~texture_upload_pool();
+
+    //format/type describe pixels, which must hold exactly the region
+    template<GLenum TARGET>
+    void upload(texture<TARGET>& tex, GLint level, GLint x, GLsizei width,
+                GLenum format, GLenum type, std::span<const std::byte> pixels) {
+        tex.sub_image(level, x, width, format, type, this->stage(pixels));
+        this->end_upload(pixels.size());
+    }
+    template<GLenum TARGET>
+    void upload(texture<TARGET>& tex, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+                GLenum format, GLenum type, std::span<const std::byte> pixels) {
+        tex.sub_image(level, x, y, width, height, format, type, this->stage(pixels));
+        this->end_upload(pixels.size());
+    }
+    //Also array layers (z = first layer) and cube map faces
+    template<GLenum TARGET>
+    void upload(texture<TARGET>& tex, GLint level, GLint x, GLint y, GLint z, GLsizei width, GLsizei height, GLsizei depth,
+                GLenum format, GLenum type, std::span<const std::byte> pixels) {
+        tex.sub_image(level, x, y, z, width, height, depth, format, type, this->stage(pixels));
+        this->end_upload(pixels.size());
+    }
+
+    //Fences the staging buffer being filled so it can be reused and records finished batches,
+    //call once per frame
+    void flush();
+
+    statistics stats() const;
+    void reset_stats();
+    GLsizeiptr staging_size() const;
+    size_t staging_count() const;
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct staging {
+        single_binding_buffer<GL_PIXEL_UNPACK_BUFFER> buffer;
+        std::byte* mapping;
+        //Set once the buffer is retired, the GPU may read it until signaled
+        std::optional<fence> retired;
+        clock::time_point first_upload;
+    };
+
+    //Copies pixels into staging memory and binds its buffer, returns the offset to pass as the data pointer
+    //(or pixels.data() with no unpack buffer bound for direct uploads)
+    const void* stage(std::span<const std::byte> pixels);
+    void end_upload(size_t bytes);
+    void retire_current();
+    //Non-blocking unless wait, true = the staging buffer is free
+    bool reclaim(staging&, bool wait);
+
+    std::vector<staging> _staging;
+    GLsizeiptr _staging_size;
+    size_t _current;
+    GLsizeiptr _head;
+
+    clock::time_point _upload_start;
+    statistics _stats;
+};
+
+}
+
+#endif //AGL_TEXTURE_UPLOAD_HPP
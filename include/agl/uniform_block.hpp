@@ -0,0 +1,275 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_UNIFORM_BLOCK_HPP
+#define AGL_UNIFORM_BLOCK_HPP
+
+#include<array>
+#include<tuple>
+#include<span>
+#include<cstring>
+#include<cstddef>
+#include<algorithm>
+#include<type_traits>
+#include<utility>
+
+#include "agl/opengl.hpp"
+#include "agl/objects.hpp"
+
+namespace agl
+{
+
+enum class block_layout {
+    std140,
+    std430
+};
+
+constexpr size_t layout_round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+//Size, base alignment and writer of a member type under a block layout,
+//defined for 4 byte scalars, glm vectors and matrices and std::array of those
+template<block_layout LAYOUT, typename M, typename = void>
+struct layout_type;
+
+template<block_layout LAYOUT, typename M>
+struct layout_type<LAYOUT, M, std::enable_if_t<std::is_arithmetic_v<M>>> {
+    static_assert(sizeof(M) == 4, "Block scalars must be 4 bytes (GLSL bool maps to GLuint)!");
+    constexpr static size_t align = 4;
+    constexpr static size_t size = 4;
+
+    //true = the bytes changed
+    static bool write(std::byte* dst, M const& value) {
+        if(std::memcmp(dst, &value, size) == 0) {
+            return false;
+        }
+        std::memcpy(dst, &value, size);
+        return true;
+    }
+};
+
+template<block_layout LAYOUT, glm::length_t L, typename S, glm::qualifier Q>
+struct layout_type<LAYOUT, glm::vec<L, S, Q>> {
+    static_assert(sizeof(S) == 4, "Block vectors must have 4 byte components!");
+    constexpr static size_t align = (L == 1 ? 1 : L == 2 ? 2 : 4) * sizeof(S);
+    constexpr static size_t size = L * sizeof(S);
+
+    static bool write(std::byte* dst, glm::vec<L, S, Q> const& value) {
+        if(std::memcmp(dst, &value, size) == 0) {
+            return false;
+        }
+        std::memcpy(dst, &value, size);
+        return true;
+    }
+};
+
+//Arrays (and matrices, as arrays of column vectors): std140 rounds the element stride up to a vec4
+template<block_layout LAYOUT, typename E>
+struct layout_array_stride {
+    constexpr static size_t align = LAYOUT == block_layout::std140
+        ? layout_round_up(layout_type<LAYOUT, E>::align, 16)
+        : layout_type<LAYOUT, E>::align;
+    constexpr static size_t stride = layout_round_up(layout_type<LAYOUT, E>::size, align);
+};
+
+template<block_layout LAYOUT, typename E, size_t N>
+struct layout_type<LAYOUT, std::array<E, N>> {
+    constexpr static size_t align = layout_array_stride<LAYOUT, E>::align;
+    constexpr static size_t stride = layout_array_stride<LAYOUT, E>::stride;
+    constexpr static size_t size = stride * N;
+
+    static bool write(std::byte* dst, std::array<E, N> const& value) {
+        bool changed = false;
+        for(size_t index = 0; index < N; index++) {
+            changed |= layout_type<LAYOUT, E>::write(dst + index * stride, value[index]);
+        }
+        return changed;
+    }
+};
+
+template<block_layout LAYOUT, glm::length_t C, glm::length_t R, typename S, glm::qualifier Q>
+struct layout_type<LAYOUT, glm::mat<C, R, S, Q>> {
+    using column = glm::vec<R, S, Q>;
+    constexpr static size_t align = layout_array_stride<LAYOUT, column>::align;
+    constexpr static size_t stride = layout_array_stride<LAYOUT, column>::stride;
+    constexpr static size_t size = stride * C;
+
+    static bool write(std::byte* dst, glm::mat<C, R, S, Q> const& value) {
+        bool changed = false;
+        for(glm::length_t index = 0; index < C; index++) {
+            changed |= layout_type<LAYOUT, column>::write(dst + index * stride, value[index]);
+        }
+        return changed;
+    }
+};
+
+template<typename T, typename M>
+struct block_member {
+    const char* name;
+    M T::* pointer;
+};
+template<typename T, typename M>
+block_member(const char*, M T::*) -> block_member<T, M>;
+
+//Specialize for each block struct with its members in GLSL declaration order:
+//  template<> struct agl::block_members<camera> {
+//      constexpr static auto members = std::make_tuple(
+//          agl::block_member{"view", &camera::view},
+//          agl::block_member{"position", &camera::position});
+//  };
+template<typename T>
+struct block_members;
+
+template<typename T, block_layout LAYOUT>
+struct block_info {
+private:
+    constexpr static auto& members = block_members<T>::members;
+    constexpr static size_t count = std::tuple_size_v<std::remove_cvref_t<decltype(members)>>;
+
+    template<size_t I>
+    using member_type = layout_type<LAYOUT,
+        std::remove_cvref_t<decltype(std::declval<T const&>().*(std::get<I>(members).pointer))>>;
+
+    template<size_t... I>
+    constexpr static std::array<size_t, count> compute_offsets(std::index_sequence<I...>) {
+        std::array<size_t, count> result{};
+        size_t offset = 0;
+        ((offset = layout_round_up(offset, member_type<I>::align),
+          result[I] = offset,
+          offset += member_type<I>::size), ...);
+        return result;
+    }
+    template<size_t... I>
+    constexpr static size_t compute_size(std::index_sequence<I...>) {
+        size_t end = 0;
+        ((end = offsets[I] + member_type<I>::size), ...);
+        size_t align = std::max({size_t(LAYOUT == block_layout::std140 ? 16 : 4), member_type<I>::align...});
+        return layout_round_up(end, align);
+    }
+
+public:
+    constexpr static std::array<size_t, count> offsets = compute_offsets(std::make_index_sequence<count>());
+    constexpr static size_t size = compute_size(std::make_index_sequence<count>());
+
+    template<size_t I>
+    constexpr static size_t member_size() {return member_type<I>::size;}
+
+    //Writes member I into a block laid out at dst, true = the bytes changed
+    template<size_t I>
+    static bool write_member(std::byte* dst, T const& value) {
+        return member_type<I>::write(dst + offsets[I], value.*(std::get<I>(members).pointer));
+    }
+    template<size_t I, typename M>
+    static bool write_member(std::byte* dst, M T::* pointer, M const& value) {
+        if constexpr(std::is_same_v<std::remove_cv_t<decltype(std::get<I>(members).pointer)>, M T::*>) {
+            if(std::get<I>(members).pointer == pointer) {
+                return member_type<I>::write(dst + offsets[I], value);
+            }
+        }
+        return false;
+    }
+    constexpr static std::array<const char*, count> names() {
+        return [&]<size_t... I>(std::index_sequence<I...>) {
+            return std::array<const char*, count>{std::get<I>(members).name...};
+        }(std::make_index_sequence<count>());
+    }
+    constexpr static size_t member_count = count;
+};
+
+//Checks offsets and size against the program's reflected block,
+//prints mismatches in debug builds, true = layouts agree
+bool validate_block_layout(
+    program&,
+    GLenum target,
+    const char* block_name,
+    size_t size,
+    std::span<const char* const> member_names,
+    std::span<const size_t> member_offsets
+);
+
+//CPU staging copy of a GLSL interface block, only the changed byte range is uploaded
+template<typename T, GLenum TARGET, block_layout LAYOUT>
+struct interface_block {
+
+    static_assert(
+        TARGET == GL_UNIFORM_BUFFER ||
+        TARGET == GL_SHADER_STORAGE_BUFFER,
+        "Invalid TARGET when instantiating agl::interface_block! "
+        "(Use agl::uniform_block or agl::shader_storage_block)"
+    );
+
+public:
+    using info = block_info<T, LAYOUT>;
+
+    interface_block(interface_block&) = delete;
+
+    interface_block()
+        : _staging{},
+          _dirty_begin(0),
+          _dirty_end(info::size)
+    {
+        this->_buffer.storage(info::size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    }
+    interface_block(interface_block&&) noexcept = default;
+
+    template<typename M>
+    void set(M T::* member, M const& value) {
+        constexpr size_t count = info::member_count;
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            ((info::template write_member<I>(this->_staging.data(), member, value)
+                && (this->mark_dirty(info::offsets[I], info::template member_size<I>()), true)), ...);
+        }(std::make_index_sequence<count>());
+    }
+    void set(T const& value) {
+        constexpr size_t count = info::member_count;
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            ((info::template write_member<I>(this->_staging.data(), value)
+                && (this->mark_dirty(info::offsets[I], info::template member_size<I>()), true)), ...);
+        }(std::make_index_sequence<count>());
+    }
+
+    void upload() {
+        if(this->_dirty_begin < this->_dirty_end) {
+            this->_buffer.sub_data(this->_dirty_begin, this->_dirty_end - this->_dirty_begin,
+                this->_staging.data() + this->_dirty_begin);
+            this->_dirty_begin = info::size;
+            this->_dirty_end = 0;
+        }
+    }
+    //Uploads pending changes then binds to the indexed binding point
+    void bind(GLuint index) {
+        this->upload();
+        this->_buffer.bind_base(index);
+    }
+
+    bool validate(program& prog, const char* block_name) {
+        constexpr auto names = info::names();
+        return validate_block_layout(prog, TARGET, block_name, info::size, names, info::offsets);
+    }
+
+    single_binding_buffer<TARGET>& get_buffer() {
+        return this->_buffer;
+    }
+
+    constexpr static GLsizeiptr size = info::size;
+
+private:
+    void mark_dirty(size_t offset, size_t length) {
+        this->_dirty_begin = std::min(this->_dirty_begin, offset);
+        this->_dirty_end = std::max(this->_dirty_end, offset + length);
+    }
+
+    single_binding_buffer<TARGET> _buffer;
+    std::array<std::byte, info::size> _staging;
+    size_t _dirty_begin;
+    size_t _dirty_end;
+};
+
+template<typename T>
+using uniform_block = interface_block<T, GL_UNIFORM_BUFFER, block_layout::std140>;
+template<typename T>
+using shader_storage_block = interface_block<T, GL_SHADER_STORAGE_BUFFER, block_layout::std430>;
+
+}
+
+#endif //AGL_UNIFORM_BLOCK_HPP
@@ -0,0 +1,188 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#ifndef AGL_VERTEX_FORMAT_HPP
+#define AGL_VERTEX_FORMAT_HPP
+
+#include<vector>
+#include<map>
+#include<memory>
+#include<tuple>
+#include<span>
+#include<cstddef>
+#include<cstdint>
+#include<type_traits>
+#include<utility>
+
+#include "agl/opengl.hpp"
+#include "agl/objects.hpp"
+
+namespace agl
+{
+
+//Component count and GL type of a vertex member, defined for scalars and glm vectors of them
+template<typename M, typename = void>
+struct vertex_component;
+
+template<typename S>
+struct vertex_component<S, std::enable_if_t<std::is_arithmetic_v<S>>> {
+    static_assert(!std::is_same_v<S, double>, "Double vertex attributes are not supported!");
+    static_assert(
+        std::is_same_v<S, float> ||
+        std::is_same_v<S, std::int8_t> || std::is_same_v<S, std::uint8_t> ||
+        std::is_same_v<S, std::int16_t> || std::is_same_v<S, std::uint16_t> ||
+        std::is_same_v<S, std::int32_t> || std::is_same_v<S, std::uint32_t>,
+        "Unsupported vertex attribute type! "
+        "(Use float or a fixed width integer of at most 32 bits, e.g. std::uint8_t instead of bool or char)"
+    );
+    constexpr static GLint size = 1;
+    constexpr static bool integer = std::is_integral_v<S>;
+    constexpr static GLenum type =
+        std::is_same_v<S, float> ? GL_FLOAT :
+        std::is_same_v<S, std::int8_t> ? GL_BYTE :
+        std::is_same_v<S, std::uint8_t> ? GL_UNSIGNED_BYTE :
+        std::is_same_v<S, std::int16_t> ? GL_SHORT :
+        std::is_same_v<S, std::uint16_t> ? GL_UNSIGNED_SHORT :
+        std::is_same_v<S, std::int32_t> ? GL_INT :
+        GL_UNSIGNED_INT;
+};
+
+template<glm::length_t L, typename S, glm::qualifier Q>
+struct vertex_component<glm::vec<L, S, Q>> {
+    constexpr static GLint size = L;
+    constexpr static bool integer = vertex_component<S>::integer;
+    constexpr static GLenum type = vertex_component<S>::type;
+};
+
+//normalized integer members are read as floats in [0, 1] / [-1, 1], other integer members as ints
+template<typename T, typename M>
+struct vertex_attribute {
+    GLuint location;
+    M T::* pointer;
+    bool normalized = false;
+};
+template<typename T, typename M>
+vertex_attribute(GLuint, M T::*) -> vertex_attribute<T, M>;
+template<typename T, typename M>
+vertex_attribute(GLuint, M T::*, bool) -> vertex_attribute<T, M>;
+
+//Specialize for each vertex struct (and optionally give it a divisor for per-instance streams):
+//  template<> struct agl::vertex_members<mesh_vertex> {
+//      constexpr static auto members = std::make_tuple(
+//          agl::vertex_attribute{0, &mesh_vertex::position},
+//          agl::vertex_attribute{1, &mesh_vertex::color, true});
+//  };
+template<typename T>
+struct vertex_members;
+
+//Attribute layout of one or more vertex streams, stream i is read from vertex buffer binding i
+struct vertex_format {
+public:
+    struct attribute {
+        GLuint location;
+        GLuint binding;
+        GLint size;
+        GLenum type;
+        bool normalized;
+        bool integer;
+        GLuint offset;
+    };
+    struct stream {
+        GLsizei stride;
+        GLuint divisor;
+    };
+
+    vertex_format(std::vector<attribute> attributes, std::vector<stream> streams);
+
+    //One shared instance per stream list, its address identifies the format in vertex_array_cache
+    template<typename... Streams>
+    static vertex_format const& of() {
+        static const vertex_format format = [] {
+            std::vector<attribute> attributes;
+            std::vector<stream> streams;
+            GLuint binding = 0;
+            (add_stream<Streams>(attributes, streams, binding++), ...);
+            return vertex_format(std::move(attributes), std::move(streams));
+        }();
+        return format;
+    }
+
+    //Programs attribute formats, bindings and divisors with glVertexAttribFormat and friends
+    void apply(vertex_array&) const;
+    //Attaches buffers (one per stream, offsets may be empty) with glBindVertexBuffer
+    void bind_buffers(vertex_array&, std::span<buffer* const> vertex_buffers, std::span<const GLintptr> offsets = {}) const;
+
+    std::span<const attribute> attributes() const;
+    std::span<const stream> streams() const;
+
+private:
+    template<typename T, typename M>
+    static GLuint member_offset(M T::* pointer) {
+        //Member pointers cannot be turned into offsets in a constant expression, measured once per format
+        alignas(T) static const std::byte storage[sizeof(T)] = {};
+        T const* base = reinterpret_cast<T const*>(storage);
+        return static_cast<GLuint>(reinterpret_cast<std::byte const*>(&(base->*pointer)) - storage);
+    }
+
+    template<typename T>
+    static void add_stream(std::vector<attribute>& attributes, std::vector<stream>& streams, GLuint binding) {
+        std::apply([&](auto const&... members) {
+            (attributes.push_back(describe<T>(members, binding)), ...);
+        }, vertex_members<T>::members);
+        GLuint divisor = 0;
+        if constexpr(requires {vertex_members<T>::divisor;}) {
+            divisor = vertex_members<T>::divisor;
+        }
+        streams.push_back({static_cast<GLsizei>(sizeof(T)), divisor});
+    }
+
+    template<typename T, typename M>
+    static attribute describe(vertex_attribute<T, M> const& member, GLuint binding) {
+        using component = vertex_component<M>;
+        return {
+            member.location, binding, component::size, component::type,
+            member.normalized, component::integer && !member.normalized,
+            member_offset<T>(member.pointer)
+        };
+    }
+
+    std::vector<attribute> _attributes;
+    std::vector<stream> _streams;
+};
+
+//One vertex array per (format, vertex buffers, offsets, element buffer), built on first use,
+//so switching between meshes is a single glBindVertexArray instead of respecifying attributes
+struct vertex_array_cache {
+public:
+    struct statistics {
+        size_t vertex_arrays;
+        std::uint64_t hits;
+        std::uint64_t misses;
+    };
+
+    vertex_array_cache(vertex_array_cache&) = delete;
+
+    vertex_array_cache() = default;
+    vertex_array_cache(vertex_array_cache&&) noexcept = default;
+
+    //The format and buffers must outlive the returned vertex array, element_buffer may be nullptr
+    vertex_array& get(vertex_format const&, std::span<buffer* const> vertex_buffers, buffer* element_buffer,
+                      std::span<const GLintptr> offsets = {});
+    //Drops the vertex arrays referencing buf, call before deleting it (its name may be reused)
+    void erase(buffer& buf);
+    void clear();
+
+    statistics stats() const;
+
+private:
+    //Format address, then buffer ids, offsets and the element buffer id
+    using key = std::vector<std::uintptr_t>;
+
+    std::map<key, std::unique_ptr<vertex_array>> _vertex_arrays;
+    key _lookup;
+    std::uint64_t _hits = 0;
+    std::uint64_t _misses = 0;
+};
+
+}
+
+#endif //AGL_VERTEX_FORMAT_HPP
@@ -0,0 +1,70 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#include<algorithm>
+#include<cstdint>
+
+#include "agl/arena.hpp"
+
+namespace agl {
+
+#pragma region arena
+
+arena::arena(size_t block_size)
+    : _block_size(block_size),
+      _current(0),
+      _head(0),
+      _used(0)
+{}
+arena::arena(arena&& move) noexcept
+    : _blocks(std::move(move._blocks)),
+      _block_size(move._block_size),
+      _current(move._current),
+      _head(move._head),
+      _used(move._used)
+{
+    move._current = 0;
+    move._head = 0;
+    move._used = 0;
+}
+
+void* arena::allocate(size_t size, size_t alignment) {
+    while(this->_current < this->_blocks.size()) {
+        block& current = this->_blocks[this->_current];
+        auto base = reinterpret_cast<std::uintptr_t>(current.data.get());
+        size_t offset = ((base + this->_head + alignment - 1) & ~(alignment - 1)) - base;
+        if(offset + size <= current.size) {
+            this->_head = offset + size;
+            this->_used += size;
+            return current.data.get() + offset;
+        }
+        //Blocks kept from earlier frames are reused before new ones are added
+        this->_current++;
+        this->_head = 0;
+    }
+
+    size_t block_size = std::max(this->_block_size, size + alignment);
+    this->_blocks.push_back({std::make_unique<std::byte[]>(block_size), block_size});
+    this->_current = this->_blocks.size() - 1;
+    this->_head = 0;
+    return this->allocate(size, alignment);
+}
+
+void arena::reset() {
+    this->_current = 0;
+    this->_head = 0;
+    this->_used = 0;
+}
+size_t arena::used() const {
+    return this->_used;
+}
+size_t arena::capacity() const {
+    size_t total = 0;
+    for(block const& held : this->_blocks) {
+        total += held.size;
+    }
+    return total;
+}
+
+#pragma endregion
+
+}
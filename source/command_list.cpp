@@ -0,0 +1,98 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#include<utility>
+
+#include "agl/command_list.hpp"
+
+namespace agl {
+
+#pragma region command_list
+
+command_list::command_list(size_t arena_block_size)
+    : _arena(arena_block_size),
+      _head(nullptr),
+      _tail(nullptr),
+      _size(0)
+{}
+command_list::command_list(command_list&& move) noexcept
+    : _arena(std::move(move._arena)),
+      _head(move._head),
+      _tail(move._tail),
+      _size(move._size)
+{
+    move._head = nullptr;
+    move._tail = nullptr;
+    move._size = 0;
+}
+
+void command_list::bind_program(program& prog) {
+    program* target = &prog;
+    this->record([target]() {target->bind();});
+}
+void command_list::bind_vertex_array(vertex_array& vao) {
+    vertex_array* target = &vao;
+    this->record([target]() {target->bind();});
+}
+void command_list::bind_texture(GLuint unit, any_texture& texture) {
+    any_texture* target = &texture;
+    this->record([target, unit]() {target->bind(unit);});
+}
+void command_list::bind_buffer(GLenum target, buffer& buf) {
+    buffer* bound = &buf;
+    this->record([bound, target]() {bound->bind(target);});
+}
+void command_list::bind_buffer_base(GLenum target, GLuint index, buffer& buf) {
+    buffer* bound = &buf;
+    this->record([bound, target, index]() {bound->bind_base(target, index);});
+}
+void command_list::bind_buffer_range(GLenum target, GLuint index, buffer& buf, GLintptr offset, GLsizeiptr size) {
+    buffer* bound = &buf;
+    this->record([bound, target, index, offset, size]() {bound->bind_range(target, index, offset, size);});
+}
+
+void command_list::buffer_update(buffer& buf, GLintptr offset, std::span<const std::byte> data) {
+    buffer* updated = &buf;
+    std::span<std::byte> copied = this->_arena.copy(data);
+    this->record([updated, offset, copied]() {
+        updated->sub_data(offset, static_cast<GLsizeiptr>(copied.size()), copied.data());
+    });
+}
+
+void command_list::draw_arrays(GLenum mode, GLint first, GLsizei count, GLsizei instance_count, GLuint base_instance) {
+    this->record([=]() {
+        glDrawArraysInstancedBaseInstance(mode, first, count, instance_count, base_instance);
+    });
+}
+void command_list::draw_elements(GLenum mode, GLsizei count, GLenum index_type, GLuint first_index,
+                                 GLint base_vertex, GLsizei instance_count, GLuint base_instance) {
+    size_t index_size = index_type == GL_UNSIGNED_BYTE ? 1 : index_type == GL_UNSIGNED_SHORT ? 2 : 4;
+    const void* offset = reinterpret_cast<const void*>(first_index * index_size);
+    this->record([=]() {
+        glDrawElementsInstancedBaseVertexBaseInstance(mode, count, index_type, offset, instance_count, base_vertex, base_instance);
+    });
+}
+void command_list::call(void (*function)(void* user), void* user) {
+    this->record([function, user]() {function(user);});
+}
+
+void command_list::execute() const {
+    for(node const* command = this->_head; command != nullptr; command = command->next) {
+        command->run(command);
+    }
+}
+void command_list::reset() {
+    this->_arena.reset();
+    this->_head = nullptr;
+    this->_tail = nullptr;
+    this->_size = 0;
+}
+size_t command_list::size() const {
+    return this->_size;
+}
+size_t command_list::memory_used() const {
+    return this->_arena.used();
+}
+
+#pragma endregion
+
+}
@@ -0,0 +1,145 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#include<algorithm>
+#include<bit>
+
+#include "agl/compute.hpp"
+
+namespace agl {
+
+#pragma region compute_kernel
+
+compute_kernel::compute_kernel(program& prog)
+    : _program(&prog),
+      _local_size(1, 1, 1)
+{
+    GLint size[3] = {1, 1, 1};
+    glGetProgramiv(prog.id(), GL_COMPUTE_WORK_GROUP_SIZE, size);
+    this->_local_size = glm::uvec3(std::max(size[0], 1), std::max(size[1], 1), std::max(size[2], 1));
+}
+
+program& compute_kernel::get_program() {
+    return *this->_program;
+}
+glm::uvec3 compute_kernel::local_size() const {
+    return this->_local_size;
+}
+glm::uvec3 compute_kernel::groups_for(glm::uvec3 invocations) const {
+    glm::uvec3 size = this->_local_size;
+    return glm::uvec3(
+        (invocations.x + size.x - 1) / size.x,
+        (invocations.y + size.y - 1) / size.y,
+        (invocations.z + size.z - 1) / size.z
+    );
+}
+
+#pragma endregion
+
+#pragma region barrier_tracker
+
+void barrier_tracker::written(buffer& buf) {
+    this->_written[buf.id()] = ++this->_epoch;
+}
+bool barrier_tracker::read(buffer& buf, GLbitfield barrier_bits) {
+    auto found = this->_written.find(buf.id());
+    if(found == this->_written.end()) {
+        this->_stats.skipped++;
+        return false;
+    }
+    GLbitfield needed = 0;
+    for(GLbitfield bits = barrier_bits; bits != 0; bits &= bits - 1) {
+        int bit = std::countr_zero(bits);
+        if(this->_covered[bit] < found->second) {
+            needed |= GLbitfield(1) << bit;
+        }
+    }
+    if(needed == 0) {
+        this->_stats.skipped++;
+        return false;
+    }
+    this->barrier(needed);
+    return true;
+}
+void barrier_tracker::barrier(GLbitfield barrier_bits) {
+    glMemoryBarrier(barrier_bits);
+    this->_stats.barriers++;
+    for(GLbitfield bits = barrier_bits; bits != 0; bits &= bits - 1) {
+        this->_covered[std::countr_zero(bits)] = this->_epoch;
+    }
+    //Writes every bit has covered can't cause another barrier
+    std::uint64_t oldest = *std::min_element(this->_covered.begin(), this->_covered.end());
+    if(oldest == this->_epoch) {
+        this->_written.clear();
+    }
+}
+
+barrier_tracker::statistics barrier_tracker::stats() const {
+    return this->_stats;
+}
+void barrier_tracker::reset_stats() {
+    this->_stats = {};
+}
+
+#pragma endregion
+
+#pragma region compute_dispatcher
+
+void compute_dispatcher::bind_storage(GLuint index, buffer& buf, GLintptr offset, GLsizeiptr size, storage_access access) {
+    slot bound{index, &buf, offset, size, access};
+    auto found = std::find_if(this->_slots.begin(), this->_slots.end(), [&](slot const& s) {return s.index == index;});
+    if(found != this->_slots.end()) {
+        *found = bound;
+    } else {
+        this->_slots.push_back(bound);
+    }
+}
+void compute_dispatcher::unbind_storage(GLuint index) {
+    std::erase_if(this->_slots, [&](slot const& s) {return s.index == index;});
+}
+
+void compute_dispatcher::before_dispatch(compute_kernel& kernel) {
+    for(slot& bound : this->_slots) {
+        //Storage written by earlier commands must be visible, for writes too (write after write)
+        this->_barriers.read(*bound.buf, GL_SHADER_STORAGE_BARRIER_BIT);
+        bound.buf->bind_range(GL_SHADER_STORAGE_BUFFER, bound.index, bound.offset, bound.size);
+    }
+    kernel.get_program().bind();
+}
+void compute_dispatcher::after_dispatch() {
+    for(slot& bound : this->_slots) {
+        if(bound.access != storage_access::read) {
+            this->_barriers.written(*bound.buf);
+        }
+    }
+    this->_dispatches++;
+}
+
+void compute_dispatcher::dispatch(compute_kernel& kernel, glm::uvec3 groups) {
+    if(groups.x == 0 || groups.y == 0 || groups.z == 0) {
+        return;
+    }
+    this->before_dispatch(kernel);
+    glDispatchCompute(groups.x, groups.y, groups.z);
+    this->after_dispatch();
+}
+void compute_dispatcher::dispatch_threads(compute_kernel& kernel, glm::uvec3 invocations) {
+    this->dispatch(kernel, kernel.groups_for(invocations));
+}
+void compute_dispatcher::dispatch_indirect(compute_kernel& kernel, buffer& args, GLintptr offset) {
+    this->before_dispatch(kernel);
+    this->_barriers.read(args, GL_COMMAND_BARRIER_BIT);
+    args.bind(GL_DISPATCH_INDIRECT_BUFFER);
+    glDispatchComputeIndirect(offset);
+    this->after_dispatch();
+}
+
+barrier_tracker& compute_dispatcher::barriers() {
+    return this->_barriers;
+}
+std::uint64_t compute_dispatcher::dispatches() const {
+    return this->_dispatches;
+}
+
+#pragma endregion
+
+}
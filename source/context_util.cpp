@@ -1,44 +1,77 @@
 #include "agl/context_util.hpp"
 
-#include<iostream>
-#include<format>
-
 #include "glad/glad.h"
+#include "agl/debug_output.hpp"
 
 namespace agl {
 
+static bool _direct_state_access = false;
+static bool _multi_bind = false;
+static bool _parallel_shader_compile = false;
+static bool _indirect_parameters = false;
+static bool _bindless_texture = false;
+static bool _has_context_factory = false;
+static context_factory _context_factory{};
+
+static void detect_capabilities() {
+    #ifdef AGL_NO_DSA
+    _direct_state_access = false;
+    #else
+    _direct_state_access = GLAD_GL_VERSION_4_5 || GLAD_GL_ARB_direct_state_access;
+    #endif
+    _multi_bind = GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_multi_bind;
+    _parallel_shader_compile = GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile;
+    _indirect_parameters = GLAD_GL_VERSION_4_6 || GLAD_GL_ARB_indirect_parameters;
+    _bindless_texture = GLAD_GL_ARB_bindless_texture;
+}
+
 bool init() {
     int res = gladLoadGL();
+    detect_capabilities();
     return res != 0;
 }
 bool init(load_proc proc) {
     int res = gladLoadGLLoader(proc);
+    detect_capabilities();
     return res != 0;
 }
+bool init(load_proc proc, context_factory const& factory) {
+    set_context_factory(factory);
+    return init(proc);
+}
 
-//Credit for this function's core design to: https://www.khronos.org/opengl/wiki/Debug_Output
-void GLAPIENTRY gl_debug_logging_callback( 
-                GLenum source,
-                GLenum type,
-                GLuint id,
-                GLenum severity,
-                GLsizei length,
-                const GLchar* message,
-                const void* userParam )
-{
-    std::cerr << std::format("GL CALLBACK: %s type = 0x%x, severity = 0x%x, message = %s\n",
-        ( type == GL_DEBUG_TYPE_ERROR ? "** GL ERROR **" : "" ),
-        type, severity, message ) << std::endl;
+void set_context_factory(context_factory const& factory) {
+    _context_factory = factory;
+    _has_context_factory = true;
+}
+context_factory const* get_context_factory() {
+    return _has_context_factory ? &_context_factory : nullptr;
 }
-//
 
 void set_gl_debug_logging(bool enable) {
+    //Never destroyed, the context may be gone by the time static destructors run
+    static debug_output* logging = new debug_output();
     if(enable) {
-        glEnable(GL_DEBUG_OUTPUT);
-        glDebugMessageCallback(gl_debug_logging_callback, 0);
+        logging->enable();
     } else {
-        glDisable(GL_DEBUG_OUTPUT);
+        logging->disable();
     }
 }
 
-}
\ No newline at end of file
+bool direct_state_access() {
+    return _direct_state_access;
+}
+bool multi_bind() {
+    return _multi_bind;
+}
+bool parallel_shader_compile() {
+    return _parallel_shader_compile;
+}
+bool indirect_parameters() {
+    return _indirect_parameters;
+}
+bool bindless_texture() {
+    return _bindless_texture;
+}
+
+}
@@ -0,0 +1,277 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#include<iostream>
+#include<format>
+#include<algorithm>
+#include<bit>
+#include<cstring>
+
+#include "agl/debug_output.hpp"
+
+namespace agl {
+
+#pragma region debug_output
+
+static std::string_view source_name(GLenum source) {
+    switch(source) {
+        case GL_DEBUG_SOURCE_API: return "api";
+        case GL_DEBUG_SOURCE_WINDOW_SYSTEM: return "window system";
+        case GL_DEBUG_SOURCE_SHADER_COMPILER: return "shader compiler";
+        case GL_DEBUG_SOURCE_THIRD_PARTY: return "third party";
+        case GL_DEBUG_SOURCE_APPLICATION: return "application";
+        default: return "other";
+    }
+}
+static std::string_view type_name(GLenum type) {
+    switch(type) {
+        case GL_DEBUG_TYPE_ERROR: return "ERROR";
+        case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "deprecated";
+        case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return "undefined behavior";
+        case GL_DEBUG_TYPE_PORTABILITY: return "portability";
+        case GL_DEBUG_TYPE_PERFORMANCE: return "performance";
+        case GL_DEBUG_TYPE_MARKER: return "marker";
+        case GL_DEBUG_TYPE_PUSH_GROUP: return "push group";
+        case GL_DEBUG_TYPE_POP_GROUP: return "pop group";
+        default: return "other";
+    }
+}
+static std::string_view severity_name(GLenum severity) {
+    switch(severity) {
+        case GL_DEBUG_SEVERITY_HIGH: return "high";
+        case GL_DEBUG_SEVERITY_MEDIUM: return "medium";
+        case GL_DEBUG_SEVERITY_LOW: return "low";
+        default: return "notification";
+    }
+}
+//Notification = 0 .. high = 3
+static int severity_rank(GLenum severity) {
+    switch(severity) {
+        case GL_DEBUG_SEVERITY_HIGH: return 3;
+        case GL_DEBUG_SEVERITY_MEDIUM: return 2;
+        case GL_DEBUG_SEVERITY_LOW: return 1;
+        default: return 0;
+    }
+}
+
+debug_output::debug_output()
+    : debug_output(config{})
+{}
+debug_output::debug_output(config const& settings)
+    : _config(settings),
+      _ring(std::make_unique<message[]>(std::bit_ceil(std::max<size_t>(settings.ring_capacity, 2)))),
+      _mask(std::bit_ceil(std::max<size_t>(settings.ring_capacity, 2)) - 1)
+{
+    for(size_t index = 0; index <= this->_mask; index++) {
+        this->_ring[index].sequence.store(index, std::memory_order_relaxed);
+    }
+}
+debug_output::~debug_output() {
+    this->disable();
+    this->write_repeats();
+}
+
+void debug_output::enable() {
+    if(this->_enabled) {
+        return;
+    }
+    glEnable(GL_DEBUG_OUTPUT);
+    if(this->_config.synchronous) {
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    } else {
+        glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    }
+    const GLenum severities[] = {
+        GL_DEBUG_SEVERITY_NOTIFICATION, GL_DEBUG_SEVERITY_LOW, GL_DEBUG_SEVERITY_MEDIUM, GL_DEBUG_SEVERITY_HIGH
+    };
+    for(GLenum severity : severities) {
+        this->filter(GL_DONT_CARE, GL_DONT_CARE, severity, severity_rank(severity) >= severity_rank(this->_config.min_severity));
+    }
+
+    this->_stop.store(false);
+    this->_drain = std::thread(&debug_output::run, this);
+    glDebugMessageCallback(&debug_output::callback, this);
+    this->_enabled = true;
+}
+void debug_output::disable() {
+    if(!this->_enabled) {
+        return;
+    }
+    glDebugMessageCallback(nullptr, nullptr);
+    glDisable(GL_DEBUG_OUTPUT);
+    this->_stop.store(true);
+    this->_drain.join();
+    while(this->consume());
+    this->_enabled = false;
+}
+bool debug_output::enabled() const {
+    return this->_enabled;
+}
+
+void debug_output::filter(GLenum source, GLenum type, GLenum severity, bool enable) {
+    glDebugMessageControl(source, type, severity, 0, nullptr, enable ? GL_TRUE : GL_FALSE);
+}
+void debug_output::filter(GLenum source, GLenum type, std::span<const GLuint> ids, bool enable) {
+    glDebugMessageControl(source, type, GL_DONT_CARE, static_cast<GLsizei>(ids.size()), ids.data(),
+                          enable ? GL_TRUE : GL_FALSE);
+}
+
+debug_output::summary debug_output::end_frame() {
+    counters& frame = this->_frame;
+    auto take = [](std::atomic<std::uint64_t>& counter) {return counter.exchange(0, std::memory_order_relaxed);};
+    return {
+        take(frame.messages), take(frame.errors), take(frame.high), take(frame.medium),
+        take(frame.low), take(frame.notifications), take(frame.duplicates), take(frame.dropped)
+    };
+}
+debug_output::summary debug_output::totals() const {
+    counters const& total = this->_total;
+    auto read = [](std::atomic<std::uint64_t> const& counter) {return counter.load(std::memory_order_relaxed);};
+    return {
+        read(total.messages), read(total.errors), read(total.high), read(total.medium),
+        read(total.low), read(total.notifications), read(total.duplicates), read(total.dropped)
+    };
+}
+
+void debug_output::drain() {
+    if(!this->_enabled) {
+        while(this->consume());
+        return;
+    }
+    std::uint64_t target = this->_enqueue.load(std::memory_order_acquire);
+    while(this->_dequeue.load(std::memory_order_acquire) < target) {
+        std::this_thread::yield();
+    }
+}
+
+void GLAPIENTRY debug_output::callback(GLenum source, GLenum type, GLuint id, GLenum severity,
+                                       GLsizei length, const GLchar* text, const void* user) {
+    const_cast<debug_output*>(static_cast<const debug_output*>(user))->receive(source, type, id, severity, length, text);
+}
+void debug_output::receive(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* text) {
+    auto count = [&](counters& into) {
+        into.messages.fetch_add(1, std::memory_order_relaxed);
+        if(type == GL_DEBUG_TYPE_ERROR) {
+            into.errors.fetch_add(1, std::memory_order_relaxed);
+        }
+        switch(severity) {
+            case GL_DEBUG_SEVERITY_HIGH: into.high.fetch_add(1, std::memory_order_relaxed); break;
+            case GL_DEBUG_SEVERITY_MEDIUM: into.medium.fetch_add(1, std::memory_order_relaxed); break;
+            case GL_DEBUG_SEVERITY_LOW: into.low.fetch_add(1, std::memory_order_relaxed); break;
+            default: into.notifications.fetch_add(1, std::memory_order_relaxed); break;
+        }
+    };
+    count(this->_frame);
+    count(this->_total);
+
+    //Bounded multi-producer ring: a slot is free for position p once its sequence equals p
+    std::uint64_t position = this->_enqueue.load(std::memory_order_relaxed);
+    message* slot;
+    while(true) {
+        slot = &this->_ring[position & this->_mask];
+        std::uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        if(sequence == position) {
+            if(this->_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if(sequence < position) {
+            this->_frame.dropped.fetch_add(1, std::memory_order_relaxed);
+            this->_total.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            position = this->_enqueue.load(std::memory_order_relaxed);
+        }
+    }
+
+    size_t size = length >= 0 ? static_cast<size_t>(length) : std::strlen(text);
+    size = std::min(size, MAX_MESSAGE_LENGTH);
+    slot->source = source;
+    slot->type = type;
+    slot->severity = severity;
+    slot->id = id;
+    slot->length = static_cast<std::uint32_t>(size);
+    std::memcpy(slot->text, text, size);
+    slot->sequence.store(position + 1, std::memory_order_release);
+}
+
+void debug_output::run() {
+    auto repeats_written = std::chrono::steady_clock::now();
+    while(!this->_stop.load(std::memory_order_relaxed)) {
+        bool busy = false;
+        while(this->consume()) {
+            busy = true;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if(now - repeats_written >= this->_config.repeat_interval) {
+            this->write_repeats();
+            repeats_written = now;
+        }
+        if(!busy) {
+            std::this_thread::sleep_for(this->_config.poll_interval);
+        }
+    }
+}
+bool debug_output::consume() {
+    std::uint64_t position = this->_dequeue.load(std::memory_order_relaxed);
+    message& slot = this->_ring[position & this->_mask];
+    if(slot.sequence.load(std::memory_order_acquire) != position + 1) {
+        return false;
+    }
+    this->write(slot);
+    slot.sequence.store(position + this->_mask + 1, std::memory_order_release);
+    this->_dequeue.store(position + 1, std::memory_order_release);
+    return true;
+}
+void debug_output::write(message const& received) {
+    std::string_view text(received.text, received.length);
+    //Drivers end messages with a newline or two
+    while(!text.empty() && (text.back() == '\n' || text.back() == '\0')) {
+        text.remove_suffix(1);
+    }
+    std::string line = std::format("GL {} {} ({}, {}): {}", type_name(received.type), received.id,
+                                   source_name(received.source), severity_name(received.severity), text);
+
+    if(this->_config.deduplicate) {
+        //FNV-1a over the identifying fields and the text
+        std::uint64_t hash = 14695981039346656037ull;
+        auto mix = [&](void const* data, size_t size) {
+            for(size_t index = 0; index < size; index++) {
+                hash = (hash ^ static_cast<unsigned char const*>(data)[index]) * 1099511628211ull;
+            }
+        };
+        mix(&received.source, sizeof(GLenum));
+        mix(&received.type, sizeof(GLenum));
+        mix(&received.id, sizeof(GLuint));
+        mix(text.data(), text.size());
+        auto [seen, inserted] = this->_seen.try_emplace(hash, repeat{0, {}});
+        seen->second.count++;
+        if(!inserted) {
+            this->_frame.duplicates.fetch_add(1, std::memory_order_relaxed);
+            this->_total.duplicates.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        seen->second.line = line;
+    }
+
+    if(this->_config.sink != nullptr) {
+        this->_config.sink(line, this->_config.user);
+    } else {
+        std::cerr << line << '\n';
+    }
+}
+void debug_output::write_repeats() {
+    for(auto const& [hash, seen] : this->_seen) {
+        if(seen.count > 1) {
+            std::string line = std::format("{} (x{})", seen.line, seen.count);
+            if(this->_config.sink != nullptr) {
+                this->_config.sink(line, this->_config.user);
+            } else {
+                std::cerr << line << '\n';
+            }
+        }
+    }
+    this->_seen.clear();
+}
+
+#pragma endregion
+
+}
@@ -0,0 +1,165 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#define AGL_GL_OBJECT_ACCESS
+#define AGL_SHADER_ACCESS
+#define AGL_PROGRAM_ACCESS
+
+#include<utility>
+
+#include "agl/deletion_queue.hpp"
+
+namespace agl {
+
+#pragma region deletion_queue
+
+std::shared_mutex deletion_queue::_install_mutex;
+std::atomic<deletion_queue*> deletion_queue::_installed = nullptr;
+std::atomic<std::uint64_t> deletion_queue::_deletions = 0;
+thread_local std::uint64_t deletion_queue::_synced_deletions = 0;
+
+bool deletion_queue::batch::empty() const {
+    return this->size() == 0;
+}
+size_t deletion_queue::batch::size() const {
+    size_t total = 0;
+    for(auto const& names : this->names) {
+        total += names.size();
+    }
+    return total;
+}
+
+deletion_queue::~deletion_queue() {
+    this->uninstall();
+    this->finish();
+}
+
+void deletion_queue::install() {
+    std::unique_lock lock(_install_mutex);
+    _installed.store(this);
+}
+void deletion_queue::uninstall() {
+    //Once the lock is held no defer can still be enqueuing into this queue
+    std::unique_lock lock(_install_mutex);
+    deletion_queue* expected = this;
+    _installed.compare_exchange_strong(expected, nullptr);
+}
+
+bool deletion_queue::defer(deletable_type type, GLuint name) {
+    //Without an installed queue destructors skip the lock
+    if(_installed.load(std::memory_order_acquire) == nullptr) {
+        return false;
+    }
+    std::shared_lock lock(_install_mutex);
+    deletion_queue* installed = _installed.load(std::memory_order_acquire);
+    if(installed == nullptr) {
+        return false;
+    }
+    installed->enqueue(type, name);
+    return true;
+}
+void deletion_queue::enqueue(deletable_type type, GLuint name) {
+    std::lock_guard lock(this->_mutex);
+    this->_incoming.names[static_cast<size_t>(type)].push_back(name);
+    this->_pending++;
+    this->_stats.enqueued++;
+}
+
+void deletion_queue::seal() {
+    batch sealed;
+    {
+        std::lock_guard lock(this->_mutex);
+        if(this->_incoming.empty()) {
+            return;
+        }
+        sealed.names.swap(this->_incoming.names);
+    }
+    //Signals once every command issued so far, the ones that may still read these objects included
+    sealed.retired.emplace();
+    this->_batches.push_back(std::move(sealed));
+}
+
+void deletion_queue::delete_batch(batch& done) {
+    auto& names = done.names;
+    std::uint64_t calls = 0;
+    auto bulk = [&](deletable_type type, auto delete_names) {
+        auto& list = names[static_cast<size_t>(type)];
+        if(!list.empty()) {
+            delete_names(static_cast<GLsizei>(list.size()), list.data());
+            calls++;
+        }
+    };
+    bulk(deletable_type::buffer, [](GLsizei n, GLuint const* ids) {glDeleteBuffers(n, ids);});
+    bulk(deletable_type::vertex_array, [](GLsizei n, GLuint const* ids) {glDeleteVertexArrays(n, ids);});
+    bulk(deletable_type::query, [](GLsizei n, GLuint const* ids) {glDeleteQueries(n, ids);});
+    bulk(deletable_type::program_pipeline, [](GLsizei n, GLuint const* ids) {glDeleteProgramPipelines(n, ids);});
+    bulk(deletable_type::transform_feedback, [](GLsizei n, GLuint const* ids) {glDeleteTransformFeedbacks(n, ids);});
+    bulk(deletable_type::sampler, [](GLsizei n, GLuint const* ids) {glDeleteSamplers(n, ids);});
+    bulk(deletable_type::texture, [](GLsizei n, GLuint const* ids) {glDeleteTextures(n, ids);});
+    bulk(deletable_type::renderbuffer, [](GLsizei n, GLuint const* ids) {glDeleteRenderbuffers(n, ids);});
+    bulk(deletable_type::framebuffer, [](GLsizei n, GLuint const* ids) {glDeleteFramebuffers(n, ids);});
+    //Shaders and programs have no bulk delete
+    for(GLuint id : names[static_cast<size_t>(deletable_type::shader)]) {
+        glDeleteShader(id);
+        calls++;
+    }
+    for(GLuint id : names[static_cast<size_t>(deletable_type::program)]) {
+        glDeleteProgram(id);
+        calls++;
+    }
+
+    size_t count = done.size();
+    std::lock_guard lock(this->_mutex);
+    this->_pending -= count;
+    this->_stats.deleted += count;
+    this->_stats.delete_calls += calls;
+    this->_stats.batches++;
+}
+
+void deletion_queue::flush() {
+    this->seal();
+    bool deleted = false;
+    while(!this->_batches.empty() && this->_batches.front().retired->client_wait(0)) {
+        this->delete_batch(this->_batches.front());
+        this->_batches.pop_front();
+        deleted = true;
+    }
+    if(deleted) {
+        this->forget_deleted_bindings();
+    }
+}
+void deletion_queue::finish() {
+    this->seal();
+    bool deleted = !this->_batches.empty();
+    while(!this->_batches.empty()) {
+        this->_batches.front().retired->client_wait();
+        this->delete_batch(this->_batches.front());
+        this->_batches.pop_front();
+    }
+    if(deleted) {
+        this->forget_deleted_bindings();
+    }
+}
+void deletion_queue::forget_deleted_bindings() {
+    _synced_deletions = _deletions.fetch_add(1, std::memory_order_release) + 1;
+    forget_thread_bindings();
+}
+void deletion_queue::sync_thread_bindings() {
+    std::uint64_t deletions = _deletions.load(std::memory_order_acquire);
+    if(deletions != _synced_deletions) {
+        _synced_deletions = deletions;
+        forget_thread_bindings();
+    }
+}
+size_t deletion_queue::pending() const {
+    std::lock_guard lock(this->_mutex);
+    return this->_pending;
+}
+
+deletion_queue::statistics deletion_queue::stats() const {
+    std::lock_guard lock(this->_mutex);
+    return this->_stats;
+}
+
+#pragma endregion
+
+}
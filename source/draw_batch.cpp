@@ -0,0 +1,164 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#include<algorithm>
+#include<numeric>
+#include<tuple>
+#include<utility>
+
+#include "agl/draw_batch.hpp"
+
+namespace agl {
+
+#pragma region draw_batch
+
+//Commands plus, in the worst case of one draw per run, a draw count per command
+constexpr GLsizeiptr BYTES_PER_DRAW = sizeof(draw_elements_command) + sizeof(GLuint);
+
+static size_t index_size(GLenum index_type) {
+    switch(index_type) {
+        case GL_UNSIGNED_BYTE: return 1;
+        case GL_UNSIGNED_SHORT: return 2;
+        default: return 4;
+    }
+}
+
+draw_batch::draw_batch(GLuint max_draws, GLuint frame_count)
+    : _indirect(BYTES_PER_DRAW * max_draws, frame_count),
+      _indirect_count(false),
+      _stats{}
+{
+    this->_queued.reserve(max_draws);
+}
+draw_batch::draw_batch(draw_batch&& move) noexcept
+    : _indirect(std::move(move._indirect)),
+      _queued(std::move(move._queued)),
+      _order(std::move(move._order)),
+      _indirect_count(move._indirect_count),
+      _stats(move._stats)
+{}
+
+void draw_batch::add(program& prog, vertex_array& vao, any_texture* texture,
+                     GLenum mode, GLenum index_type, draw_elements_command const& command) {
+    this->_queued.push_back({
+        prog.id(), vao.id(), texture != nullptr ? texture->id() : 0,
+        mode, index_type, &prog, &vao, texture, command
+    });
+}
+
+bool draw_batch::same_state(queued const& a, queued const& b) {
+    return a.program_id == b.program_id && a.vao_id == b.vao_id && a.texture_id == b.texture_id
+        && a.mode == b.mode && a.index_type == b.index_type;
+}
+void draw_batch::apply_state(queued const& draw) {
+    //Binds are cached, only the ones that change reach GL
+    draw.prog->bind();
+    draw.vao->bind();
+    if(draw.texture != nullptr) {
+        draw.texture->bind(0);
+    }
+}
+
+void draw_batch::submit() {
+    size_t count = this->_queued.size();
+    if(count == 0) {
+        return;
+    }
+
+    this->_order.resize(count);
+    std::iota(this->_order.begin(), this->_order.end(), 0);
+    std::stable_sort(this->_order.begin(), this->_order.end(), [this](std::uint32_t a, std::uint32_t b) {
+        queued const& left = this->_queued[a];
+        queued const& right = this->_queued[b];
+        return std::tie(left.program_id, left.vao_id, left.texture_id, left.mode, left.index_type)
+             < std::tie(right.program_id, right.vao_id, right.texture_id, right.mode, right.index_type);
+    });
+
+    bool indirect_count = this->_indirect_count && indirect_parameters();
+    this->_indirect.bind(GL_DRAW_INDIRECT_BUFFER);
+    if(indirect_count) {
+        this->_indirect.bind(GL_PARAMETER_BUFFER);
+    }
+
+    queued const* previous = nullptr;
+    size_t run_begin = 0;
+    while(run_begin < count) {
+        queued const& first = this->_queued[this->_order[run_begin]];
+        size_t run_end = run_begin + 1;
+        while(run_end < count && same_state(first, this->_queued[this->_order[run_end]])) {
+            run_end++;
+        }
+        GLsizei run_length = static_cast<GLsizei>(run_end - run_begin);
+
+        //Runs also split on mode and index type, which need no state change
+        this->_stats.state_changes += (previous == nullptr || previous->program_id != first.program_id)
+                                    + (previous == nullptr || previous->vao_id != first.vao_id)
+                                    + (previous == nullptr || previous->texture_id != first.texture_id);
+        this->apply_state(first);
+        previous = &first;
+
+        streaming_buffer::allocation commands = this->_indirect.allocate(
+            sizeof(draw_elements_command) * run_length, alignof(draw_elements_command));
+        streaming_buffer::allocation draw_count{};
+        if(commands && indirect_count) {
+            draw_count = this->_indirect.allocate(sizeof(GLuint), sizeof(GLuint));
+        }
+
+        if(commands && (!indirect_count || draw_count)) {
+            auto* records = static_cast<draw_elements_command*>(commands.data);
+            for(size_t index = run_begin; index < run_end; index++) {
+                records[index - run_begin] = this->_queued[this->_order[index]].command;
+            }
+            const void* offset = reinterpret_cast<const void*>(commands.offset);
+            if(indirect_count) {
+                *static_cast<GLuint*>(draw_count.data) = static_cast<GLuint>(run_length);
+                if(GLAD_GL_VERSION_4_6) {
+                    glMultiDrawElementsIndirectCount(first.mode, first.index_type, offset, draw_count.offset, run_length, 0);
+                } else {
+                    glMultiDrawElementsIndirectCountARB(first.mode, first.index_type, offset, draw_count.offset, run_length, 0);
+                }
+            } else {
+                glMultiDrawElementsIndirect(first.mode, first.index_type, offset, run_length, 0);
+            }
+            this->_stats.multi_draws++;
+        } else {
+            //This frame's indirect region is full
+            size_t bytes_per_index = index_size(first.index_type);
+            for(size_t index = run_begin; index < run_end; index++) {
+                draw_elements_command const& command = this->_queued[this->_order[index]].command;
+                glDrawElementsInstancedBaseVertexBaseInstance(first.mode, command.count, first.index_type,
+                    reinterpret_cast<const void*>(command.first_index * bytes_per_index),
+                    command.instance_count, command.base_vertex, command.base_instance);
+            }
+            this->_stats.overflow_draws += run_length;
+        }
+        run_begin = run_end;
+    }
+
+    this->_stats.draws += count;
+    this->_queued.clear();
+}
+
+void draw_batch::next_frame() {
+    this->_indirect.next_frame();
+}
+void draw_batch::clear() {
+    this->_queued.clear();
+}
+size_t draw_batch::size() const {
+    return this->_queued.size();
+}
+
+void draw_batch::use_indirect_count(bool enable) {
+    this->_indirect_count = enable;
+}
+
+draw_batch::statistics draw_batch::stats() const {
+    return this->_stats;
+}
+void draw_batch::reset_stats() {
+    this->_stats = {};
+}
+
+#pragma endregion
+
+}
@@ -0,0 +1,65 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#include "agl/frame_pacer.hpp"
+
+namespace agl {
+
+#pragma region frame_pacer
+
+frame_pacer::frame_pacer(GLuint max_frames_in_flight)
+    : _fences(max_frames_in_flight > 0 ? max_frames_in_flight : 1),
+      _frame(0),
+      _last_stall(0),
+      _total_stall(0),
+      _stalled_frames(0)
+{}
+
+void frame_pacer::begin_frame() {
+    this->_last_stall = std::chrono::nanoseconds(0);
+
+    std::optional<fence>& oldest = this->_fences[this->_frame % this->_fences.size()];
+    if(oldest) {
+        if(!oldest->signaled()) {
+            auto start = std::chrono::steady_clock::now();
+            oldest->client_wait();
+            this->_last_stall = std::chrono::steady_clock::now() - start;
+            this->_total_stall += this->_last_stall;
+            this->_stalled_frames++;
+        }
+        oldest.reset();
+    }
+}
+void frame_pacer::end_frame() {
+    this->_fences[this->_frame % this->_fences.size()].emplace();
+    this->_frame++;
+}
+
+GLuint frame_pacer::max_frames_in_flight() const {
+    return static_cast<GLuint>(this->_fences.size());
+}
+GLuint frame_pacer::frames_in_flight() {
+    GLuint count = 0;
+    for(std::optional<fence>& pending : this->_fences) {
+        if(pending && !pending->signaled()) {
+            count++;
+        }
+    }
+    return count;
+}
+std::uint64_t frame_pacer::frame_count() const {
+    return this->_frame;
+}
+
+std::chrono::nanoseconds frame_pacer::last_stall() const {
+    return this->_last_stall;
+}
+std::chrono::nanoseconds frame_pacer::total_stall() const {
+    return this->_total_stall;
+}
+std::uint64_t frame_pacer::stalled_frames() const {
+    return this->_stalled_frames;
+}
+
+#pragma endregion
+
+}
@@ -0,0 +1,351 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#include<iostream>
+#include<algorithm>
+#include<bit>
+
+#include "agl/gpu_culling.hpp"
+
+namespace agl {
+
+#pragma region gpu_culler
+
+static const char* CULL_SOURCE = R"(#version 430 core
+layout(local_size_x = 64) in;
+
+struct instance {
+    vec4 sphere;
+    uint mesh;
+    uint padding[3];
+};
+struct command {
+    uint count;
+    uint instance_count;
+    uint first_index;
+    int base_vertex;
+    uint base_instance;
+};
+
+layout(std430, binding = 0) readonly buffer instances_block {
+    instance instances[];
+};
+layout(std430, binding = 1) readonly buffer meshes_block {
+    command meshes[];
+};
+layout(std430, binding = 2) writeonly buffer commands_block {
+    command commands[];
+};
+layout(binding = 0) uniform atomic_uint survivors;
+layout(binding = 0) uniform sampler2D hi_z;
+
+uniform mat4 view_projection;
+uniform uint instance_count;
+uniform bool occlusion;
+uniform bool compact;
+uniform int hi_z_levels;
+
+bool inside_frustum(vec4 sphere) {
+    mat4 rows = transpose(view_projection);
+    vec4 planes[6] = vec4[6](
+        rows[3] + rows[0], rows[3] - rows[0],
+        rows[3] + rows[1], rows[3] - rows[1],
+        rows[3] + rows[2], rows[3] - rows[2]
+    );
+    for(int index = 0; index < 6; index++) {
+        vec4 plane = planes[index];
+        if(dot(plane.xyz, sphere.xyz) + plane.w < -sphere.w * length(plane.xyz)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//Screen rectangle and nearest depth of the sphere's bounding box against the max depth in the pyramid level
+//where the rectangle spans at most 2x2 texels
+bool unoccluded(vec4 sphere) {
+    vec3 low = vec3(1.0);
+    vec3 high = vec3(-1.0);
+    for(int corner = 0; corner < 8; corner++) {
+        vec3 direction = vec3((corner & 1) != 0 ? 1.0 : -1.0, (corner & 2) != 0 ? 1.0 : -1.0, (corner & 4) != 0 ? 1.0 : -1.0);
+        vec4 clip = view_projection * vec4(sphere.xyz + direction * sphere.w, 1.0);
+        if(clip.w <= 0.0) {
+            return true;
+        }
+        vec3 ndc = clip.xyz / clip.w;
+        low = min(low, ndc);
+        high = max(high, ndc);
+    }
+    vec2 uv_low = clamp(low.xy * 0.5 + 0.5, 0.0, 1.0);
+    vec2 uv_high = clamp(high.xy * 0.5 + 0.5, 0.0, 1.0);
+    vec2 extent = (uv_high - uv_low) * vec2(textureSize(hi_z, 0));
+    int level = clamp(int(ceil(log2(max(max(extent.x, extent.y), 1.0)))), 0, hi_z_levels - 1);
+    //Not textureSize(hi_z, level): some drivers (llvmpipe) mishandle a level that differs between invocations
+    ivec2 size = max(textureSize(hi_z, 0) >> level, ivec2(1));
+    ivec2 first = clamp(ivec2(uv_low * vec2(size)), ivec2(0), size - 1);
+    ivec2 last = clamp(ivec2(uv_high * vec2(size)), ivec2(0), size - 1);
+    float occluder = max(
+        max(texelFetch(hi_z, first, level).r, texelFetch(hi_z, ivec2(last.x, first.y), level).r),
+        max(texelFetch(hi_z, ivec2(first.x, last.y), level).r, texelFetch(hi_z, last, level).r)
+    );
+    return low.z * 0.5 + 0.5 <= occluder;
+}
+
+void main() {
+    uint index = gl_GlobalInvocationID.x;
+    if(index >= instance_count) {
+        return;
+    }
+    instance item = instances[index];
+    bool visible = inside_frustum(item.sphere) && (!occlusion || unoccluded(item.sphere));
+
+    command drawn = meshes[item.mesh];
+    drawn.instance_count = 1;
+    drawn.base_instance = index;
+    if(compact) {
+        if(visible) {
+            commands[atomicCounterIncrement(survivors)] = drawn;
+        }
+    } else {
+        if(visible) {
+            atomicCounterIncrement(survivors);
+        } else {
+            drawn.instance_count = 0;
+        }
+        commands[index] = drawn;
+    }
+}
+)";
+
+static const char* COPY_SOURCE = R"(#version 430 core
+layout(local_size_x = 8, local_size_y = 8) in;
+layout(binding = 0) uniform sampler2D depth;
+layout(r32f, binding = 0) writeonly uniform image2D destination;
+void main() {
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    if(any(greaterThanEqual(texel, imageSize(destination)))) {
+        return;
+    }
+    imageStore(destination, texel, vec4(texelFetch(depth, texel, 0).r));
+}
+)";
+
+//Odd source sizes fold their last row/column into the last destination texel so no depth is lost
+static const char* REDUCE_SOURCE = R"(#version 430 core
+layout(local_size_x = 8, local_size_y = 8) in;
+layout(binding = 0) uniform sampler2D source;
+layout(r32f, binding = 0) writeonly uniform image2D destination;
+uniform int source_level;
+void main() {
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 size = imageSize(destination);
+    if(any(greaterThanEqual(texel, size))) {
+        return;
+    }
+    ivec2 source_size = textureSize(source, source_level);
+    ivec2 first = texel * 2;
+    ivec2 last = first + 1 + ivec2(equal(texel, size - 1)) * (source_size & 1);
+    last = min(last, source_size - 1);
+    float depth = 0.0;
+    for(int y = first.y; y <= last.y; y++) {
+        for(int x = first.x; x <= last.x; x++) {
+            depth = max(depth, texelFetch(source, ivec2(x, y), source_level).r);
+        }
+    }
+    imageStore(destination, texel, vec4(depth));
+}
+)";
+
+gpu_culler::gpu_culler(GLuint max_instances)
+    : _valid(false),
+      _max_instances(max_instances),
+      _instance_count(0),
+      _mesh_count(0),
+      _hi_z_width(0),
+      _hi_z_height(0),
+      _hi_z_levels(0),
+      _use_hi_z(false),
+      _stats{}
+{
+    //Compute kernels and multi-draw indirect need GL 4.3, the buffers are allocated with glBufferStorage
+    if(!GLAD_GL_VERSION_4_3 || !(GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage)) {
+        #ifndef NDEBUG
+        std::cerr << "Error: gpu_culler needs GL 4.3 and GL 4.4 or ARB_buffer_storage!" << std::endl;
+        #endif
+        return;
+    }
+    this->_valid = this->build(this->_cull_program, CULL_SOURCE) &&
+                   this->build(this->_copy_program, COPY_SOURCE) &&
+                   this->build(this->_reduce_program, REDUCE_SOURCE);
+    if(!this->_valid) {
+        return;
+    }
+    this->_cull.emplace(this->_cull_program);
+    this->_copy.emplace(this->_copy_program);
+    this->_reduce.emplace(this->_reduce_program);
+
+    GLsizeiptr instances = std::max<GLsizeiptr>(max_instances, 1);
+    this->_instances.storage(instances * sizeof(cull_instance), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    this->_commands.storage(instances * sizeof(draw_elements_command), nullptr, 0);
+    this->_count.storage(sizeof(GLuint), nullptr, GL_DYNAMIC_STORAGE_BIT);
+}
+
+bool gpu_culler::build(program& prog, const char* source) {
+    compute_shader shader;
+    shader.compile(source);
+    prog.attach_shader(shader);
+    prog.link();
+    prog.detach_shader(shader);
+    #ifndef NDEBUG
+    if(!prog.link_success()) {
+        std::cerr << "Error: gpu_culler kernel failed to link!\n" << prog.info_log() << std::endl;
+    }
+    #endif
+    return prog.link_success();
+}
+
+bool gpu_culler::valid() const {
+    return this->_valid;
+}
+GLuint gpu_culler::max_instances() const {
+    return this->_max_instances;
+}
+
+void gpu_culler::set_meshes(std::span<const draw_elements_command> meshes) {
+    if(!this->_valid) {
+        return;
+    }
+    GLsizeiptr size = static_cast<GLsizeiptr>(std::max<size_t>(meshes.size_bytes(), sizeof(draw_elements_command)));
+    this->_mesh_count = static_cast<GLuint>(meshes.size());
+    this->_meshes.emplace();
+    this->_meshes->storage(size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    if(!meshes.empty()) {
+        this->_meshes->sub_data(0, static_cast<GLsizeiptr>(meshes.size_bytes()), meshes.data());
+    }
+}
+void gpu_culler::set_instances(std::span<const cull_instance> instances) {
+    if(!this->_valid) {
+        return;
+    }
+    this->_instance_count = static_cast<GLuint>(std::min<size_t>(instances.size(), this->_max_instances));
+    if(this->_instance_count != 0) {
+        this->_instances.sub_data(0, this->_instance_count * sizeof(cull_instance), instances.data());
+    }
+}
+
+void gpu_culler::build_hi_z(texture_2d& depth, GLsizei width, GLsizei height) {
+    if(!this->_valid || width <= 0 || height <= 0) {
+        return;
+    }
+    if(!this->_hi_z || this->_hi_z_width != width || this->_hi_z_height != height) {
+        this->_hi_z_levels = std::bit_width(static_cast<unsigned int>(std::max(width, height)));
+        this->_hi_z.emplace();
+        this->_hi_z->storage(this->_hi_z_levels, GL_R32F, width, height);
+        this->_hi_z_width = width;
+        this->_hi_z_height = height;
+    }
+
+    //The pyramid kernels use no storage, the cull pass's slots would otherwise be rebound and marked written
+    for(GLuint slot = 0; slot < 3; slot++) {
+        this->_dispatcher.unbind_storage(slot);
+    }
+    depth.bind(0);
+    glBindImageTexture(0, this->_hi_z->id(), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+    this->_dispatcher.dispatch_threads(*this->_copy, glm::uvec3(width, height, 1));
+
+    this->_hi_z->bind(0);
+    this->_reduce_program.bind();
+    GLint source_level = this->_reduce_program.uniform_location("source_level");
+    for(GLint level = 1; level < this->_hi_z_levels; level++) {
+        this->_dispatcher.barriers().barrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+        glBindImageTexture(0, this->_hi_z->id(), level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+        program::bound::set_uniform(source_level, level - 1);
+        GLuint level_width = std::max(width >> level, 1);
+        GLuint level_height = std::max(height >> level, 1);
+        this->_dispatcher.dispatch_threads(*this->_reduce, glm::uvec3(level_width, level_height, 1));
+    }
+    this->_dispatcher.barriers().barrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    this->_use_hi_z = true;
+    this->_stats.pyramids++;
+}
+void gpu_culler::clear_hi_z() {
+    this->_use_hi_z = false;
+}
+
+void gpu_culler::cull(glm::mat4 const& view_projection) {
+    if(!this->_valid || !this->_meshes) {
+        return;
+    }
+    barrier_tracker& barriers = this->_dispatcher.barriers();
+    const GLuint zero = 0;
+    barriers.read(this->_count, GL_BUFFER_UPDATE_BARRIER_BIT);
+    this->_count.sub_data(0, sizeof(GLuint), &zero);
+    this->_count.bind_base(GL_ATOMIC_COUNTER_BUFFER, 0);
+    if(this->_use_hi_z) {
+        this->_hi_z->bind(0);
+    }
+
+    program& prog = this->_cull_program;
+    prog.bind();
+    program::bound::set_uniform(prog.uniform_location("view_projection"), view_projection);
+    program::bound::set_uniform(prog.uniform_location("instance_count"), this->_instance_count);
+    program::bound::set_uniform(prog.uniform_location("occlusion"), this->_use_hi_z ? 1 : 0);
+    program::bound::set_uniform(prog.uniform_location("compact"), indirect_parameters() ? 1 : 0);
+    program::bound::set_uniform(prog.uniform_location("hi_z_levels"), this->_hi_z_levels);
+
+    GLsizeiptr instances = std::max<GLsizeiptr>(this->_instance_count, 1);
+    GLsizeiptr meshes = std::max<GLsizeiptr>(this->_mesh_count, 1);
+    this->_dispatcher.bind_storage(0, this->_instances, 0, instances * sizeof(cull_instance), storage_access::read);
+    this->_dispatcher.bind_storage(1, *this->_meshes, 0, meshes * sizeof(draw_elements_command), storage_access::read);
+    this->_dispatcher.bind_storage(2, this->_commands, 0, instances * sizeof(draw_elements_command), storage_access::write);
+    this->_dispatcher.dispatch_threads(*this->_cull, glm::uvec3(this->_instance_count, 1, 1));
+    barriers.written(this->_count);
+    this->_stats.culls++;
+}
+
+void gpu_culler::draw(GLenum mode, GLenum index_type) {
+    if(!this->_valid || this->_instance_count == 0) {
+        return;
+    }
+    barrier_tracker& barriers = this->_dispatcher.barriers();
+    barriers.read(this->_commands, GL_COMMAND_BARRIER_BIT);
+    barriers.read(this->_count, GL_COMMAND_BARRIER_BIT);
+    this->_commands.bind(GL_DRAW_INDIRECT_BUFFER);
+    if(indirect_parameters()) {
+        this->_count.bind(GL_PARAMETER_BUFFER);
+        if(GLAD_GL_VERSION_4_6) {
+            glMultiDrawElementsIndirectCount(mode, index_type, nullptr, 0, this->_instance_count, 0);
+        } else {
+            glMultiDrawElementsIndirectCountARB(mode, index_type, nullptr, 0, this->_instance_count, 0);
+        }
+    } else {
+        glMultiDrawElementsIndirect(mode, index_type, nullptr, this->_instance_count, 0);
+    }
+    this->_stats.draws++;
+}
+
+GLuint gpu_culler::read_visible_count() {
+    if(!this->_valid) {
+        return 0;
+    }
+    barrier_tracker& barriers = this->_dispatcher.barriers();
+    barriers.read(this->_count, GL_BUFFER_UPDATE_BARRIER_BIT);
+    GLuint visible = 0;
+    this->_count.bind(GL_COPY_READ_BUFFER);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(GLuint), &visible);
+    return visible;
+}
+
+buffer& gpu_culler::commands() {
+    return this->_commands;
+}
+buffer& gpu_culler::count() {
+    return this->_count;
+}
+
+gpu_culler::statistics gpu_culler::stats() const {
+    return this->_stats;
+}
+
+#pragma endregion
+
+}
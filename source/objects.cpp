@@ -5,8 +5,12 @@
 #define AGL_PROGRAM_ACCESS
 
 #include<iostream>
+#include<algorithm>
+#include<iterator>
+#include<cstring>
 
 #include "agl/objects.hpp"
+#include "agl/deletion_queue.hpp"
 
 #define STATIC_DEF(x) thread_local decltype(x) x
 
@@ -15,7 +19,11 @@ namespace agl {
 #pragma region buffer
 
 buffer::buffer() {
-    glGenBuffers(1, &this->_id);
+    if(direct_state_access()) {
+        glCreateBuffers(1, &this->_id);
+    } else {
+        glGenBuffers(1, &this->_id);
+    }
 }
 buffer::buffer(buffer&& move) noexcept
     : _id(move._id)
@@ -24,23 +32,127 @@ buffer::buffer(buffer&& move) noexcept
 }
 buffer::~buffer() {
     if(this->_id != 0) {
-        for(auto& val : _bindings) {
-            if(val.second == _id) {
-                val.second = 0;
+        //Deferred names stay bound until the queue deletes them, so the cached bindings stay true
+        if(deletion_queue::defer(deletable_type::buffer, this->_id)) {
+            return;
+        }
+        //Deleting a buffer unbinds it from every binding point, indexed ones included
+        for(GLuint& bound : _bindings) {
+            if(bound == this->_id) {
+                bound = 0;
+            }
+        }
+        for(size_t target = 0; target < INDEXED_TARGET_COUNT; target++) {
+            for(GLuint index = 0; index < _indexed_high_water[target]; index++) {
+                if(_indexed_bindings[target][index].id == this->_id) {
+                    _indexed_bindings[target][index] = {0, 0, 0};
+                }
             }
         }
         glDeleteBuffers(1, &this->_id);
     }
 }
 void buffer::bind(GLenum target) {
-    _bindings.insert_or_assign(target, this->_id);
-    glBindBuffer(target, this->_id);
+    size_t slot = target_slot(target);
+    if(slot == TARGET_COUNT) {
+        glBindBuffer(target, this->_id);
+        return;
+    }
+    if(_bindings[slot] != this->_id) {
+        glBindBuffer(target, this->_id);
+        _bindings[slot] = this->_id;
+    }
+}
+void buffer::unbind(GLenum target) {
+    size_t slot = target_slot(target);
+    if(slot == TARGET_COUNT) {
+        glBindBuffer(target, 0);
+        return;
+    }
+    if(_bindings[slot] != 0) {
+        glBindBuffer(target, 0);
+        _bindings[slot] = 0;
+    }
+}
+void buffer::bind_base(GLenum target, GLuint index) {
+    this->bind_range(target, index, 0, 0);
+}
+void buffer::bind_range(GLenum target, GLuint index, GLintptr offset, GLsizeiptr size) {
+    size_t slot = indexed_target_slot(target);
+    if(slot != INDEXED_TARGET_COUNT && index < MAX_CACHED_INDEX) {
+        indexed_binding& bound = _indexed_bindings[slot][index];
+        if(bound.id == this->_id && bound.offset == offset && bound.size == size) {
+            return;
+        }
+        bound = {this->_id, offset, size};
+        if(index >= _indexed_high_water[slot]) {
+            _indexed_high_water[slot] = index + 1;
+        }
+    }
+    if(size == 0) {
+        glBindBufferBase(target, index, this->_id);
+    } else {
+        glBindBufferRange(target, index, this->_id, offset, size);
+    }
+    //Indexed binds also replace the generic binding point
+    size_t generic_slot = target_slot(target);
+    if(generic_slot != TARGET_COUNT) {
+        _bindings[generic_slot] = this->_id;
+    }
 }
 GLuint buffer::id() {
     return this->_id;
 }
+void buffer::storage(GLsizeiptr size, const void* data, GLbitfield flags) {
+    if(direct_state_access()) {
+        glNamedBufferStorage(this->_id, size, data, flags);
+    } else {
+        this->bind(GL_COPY_WRITE_BUFFER);
+        glBufferStorage(GL_COPY_WRITE_BUFFER, size, data, flags);
+    }
+}
+void buffer::data(GLsizeiptr size, const void* data, GLenum usage) {
+    if(direct_state_access()) {
+        glNamedBufferData(this->_id, size, data, usage);
+    } else {
+        this->bind(GL_COPY_WRITE_BUFFER);
+        glBufferData(GL_COPY_WRITE_BUFFER, size, data, usage);
+    }
+}
+void buffer::sub_data(GLintptr offset, GLsizeiptr size, const void* data) {
+    if(direct_state_access()) {
+        glNamedBufferSubData(this->_id, offset, size, data);
+    } else {
+        this->bind(GL_COPY_WRITE_BUFFER);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data);
+    }
+}
+void* buffer::map_range(GLintptr offset, GLsizeiptr length, GLbitfield access) {
+    if(direct_state_access()) {
+        return glMapNamedBufferRange(this->_id, offset, length, access);
+    }
+    this->bind(GL_COPY_WRITE_BUFFER);
+    return glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, length, access);
+}
+void buffer::flush_mapped_range(GLintptr offset, GLsizeiptr length) {
+    if(direct_state_access()) {
+        glFlushMappedNamedBufferRange(this->_id, offset, length);
+    } else {
+        this->bind(GL_COPY_WRITE_BUFFER);
+        glFlushMappedBufferRange(GL_COPY_WRITE_BUFFER, offset, length);
+    }
+}
+bool buffer::unmap() {
+    if(direct_state_access()) {
+        return glUnmapNamedBuffer(this->_id) != GL_FALSE;
+    }
+    this->bind(GL_COPY_WRITE_BUFFER);
+    return glUnmapBuffer(GL_COPY_WRITE_BUFFER) != GL_FALSE;
+}
 
-STATIC_DEF(buffer::_bindings);
+STATIC_DEF(buffer::_bindings){0};
+STATIC_DEF(buffer::_indexed_bindings){};
+STATIC_DEF(buffer::_indexed_high_water){0};
 
 #pragma endregion
 
@@ -51,6 +163,9 @@ STATIC_DEF(buffer::_bindings);
 any_shader::any_shader() {}
 any_shader::~any_shader() {
     if(this->_id != 0) {
+        if(deletion_queue::defer(deletable_type::shader, this->_id)) {
+            return;
+        }
         glDeleteShader(this->_id);
     }
 }
@@ -63,6 +178,27 @@ void any_shader::compile(std::string_view source) {
     glShaderSource(this->_id, 1, &data, &length);
     glCompileShader(this->_id);
 }
+void any_shader::compile(std::string_view source, std::string_view defines) {
+    //#version has to stay the first line, so the defines go right after it
+    std::string_view head;
+    std::string_view body = source;
+    if(body.starts_with("#version")) {
+        size_t line_end = body.find('\n');
+        line_end = line_end == std::string_view::npos ? body.length() : line_end + 1;
+        head = body.substr(0, line_end);
+        body = body.substr(line_end);
+    }
+    //Default constructed string_views have no data, which Mesa rejects even at length 0
+    auto text = [](std::string_view part) {return part.empty() ? "" : part.data();};
+    const GLchar* strings[3] = {text(head), text(defines), text(body)};
+    GLint lengths[3] = {
+        static_cast<GLint>(head.length()),
+        static_cast<GLint>(defines.length()),
+        static_cast<GLint>(body.length())
+    };
+    glShaderSource(this->_id, 3, strings, lengths);
+    glCompileShader(this->_id);
+}
 bool any_shader::compile_success() const  {
     GLint success;
     glGetShaderiv(this->_id, GL_COMPILE_STATUS, &success);
@@ -80,18 +216,48 @@ std::string any_shader::info_log() const {
 
 //shaders are defined in header due to template definitions
 
+#pragma region dynamic_shader
+
+dynamic_shader::dynamic_shader(GLenum type)
+    : _type(type)
+{
+    this->_id = glCreateShader(type);
+}
+dynamic_shader::dynamic_shader(dynamic_shader&& move) noexcept
+    : _type(move._type)
+{
+    this->_id = move._id;
+    move._id = 0;
+}
+GLenum dynamic_shader::type() const {
+    return this->_type;
+}
+
+#pragma endregion
+
 #pragma region program
 
 program::program() {
     this->_id = glCreateProgram();
 }
 program::program(program&& move) noexcept
-    : _id(move._id)
+    : _id(move._id),
+      _reflection(std::move(move._reflection)),
+      _shadow(std::move(move._shadow))
 {
     move._id = 0;
+    if(_bound == &move) {
+        _bound = this;
+    }
 }
 program::~program() {
+    if(_bound == this) {
+        _bound = nullptr;
+    }
     if(this->_id != 0) {
+        if(deletion_queue::defer(deletable_type::program, this->_id)) {
+            return;
+        }
         if(_bound_id == this->_id) {
             _bound_id = 0;
         }
@@ -103,6 +269,7 @@ void program::bind() {
         glUseProgram(this->_id);
         _bound_id = this->_id;
     }
+    _bound = this;
 }
 GLuint program::id() {
     return _id;
@@ -111,8 +278,16 @@ GLuint program::id() {
 void program::attach_shader(any_shader& shader) {
     glAttachShader(this->_id, shader.id());
 }
+void program::detach_shader(any_shader& shader) {
+    glDetachShader(this->_id, shader.id());
+}
 void program::link() {
     glLinkProgram(this->_id);
+    if(this->link_success()) {
+        this->reflect();
+    } else {
+        this->_reflection.clear();
+    }
 }
 bool program::link_success() const {
     GLint success;
@@ -126,8 +301,38 @@ std::string program::info_log() const {
     glGetProgramInfoLog(this->_id, BUF_SIZE, &length, buffer);
     return std::string(buffer, length);
 }
-GLint program::uniform_location(const char* name) {
-    GLint location = glGetUniformLocation(this->_id, name);
+bool program::load_binary(GLenum format, std::span<const std::byte> binary) {
+    glProgramBinary(this->_id, format, binary.data(), static_cast<GLsizei>(binary.size()));
+    if(this->link_success()) {
+        this->reflect();
+        return true;
+    }
+    this->_reflection.clear();
+    return false;
+}
+std::vector<std::byte> program::get_binary(GLenum& format) const {
+    GLint length = 0;
+    glGetProgramiv(this->_id, GL_PROGRAM_BINARY_LENGTH, &length);
+    std::vector<std::byte> binary(length);
+    if(length > 0) {
+        GLsizei written = 0;
+        glGetProgramBinary(this->_id, length, &written, &format, binary.data());
+        binary.resize(written);
+    }
+    return binary;
+}
+void program::reflect() {
+    this->_reflection.reflect(this->_id);
+    this->build_uniform_shadow();
+}
+program_reflection const& program::reflection() const {
+    return this->_reflection;
+}
+GLint program::uniform_location(const char* name) const {
+    GLint location = this->uniform_location(hashed_name{hash_name(name)});
+    if(location < 0) {
+        location = this->array_element_location(name);
+    }
     #ifndef NDEBUG
     if(location < 0) {
         std::cerr << "Error Uniform: \""<<name<<"\" Not Found!" << std::endl;
@@ -135,139 +340,369 @@ GLint program::uniform_location(const char* name) {
     #endif
     return location;
 }
+GLint program::uniform_location(hashed_name name) const {
+    program_reflection::uniform const* uniform = this->_reflection.find_uniform(name.hash);
+    return uniform != nullptr ? uniform->location : -1;
+}
+GLint program::array_element_location(std::string_view name) const {
+    //Only "name[0]" and "name" are in the table, other elements of a basic type array follow name's location
+    size_t open = name.rfind('[');
+    if(name.ends_with(']') && open != std::string_view::npos && open + 2 < name.size()) {
+        GLint element = 0;
+        for(char digit : name.substr(open + 1, name.size() - open - 2)) {
+            if(digit < '0' || digit > '9' || element > (1 << 20)) {
+                element = -1;
+                break;
+            }
+            element = element * 10 + (digit - '0');
+        }
+        program_reflection::uniform const* array = this->_reflection.find_uniform(hash_name(name.substr(0, open)));
+        if(element >= 0 && array != nullptr && array->location >= 0 && element < array->array_size) {
+            return array->location + element;
+        }
+    }
+    return -1;
+}
+GLint program::attribute_location(const char* name) const {
+    return this->attribute_location(hashed_name{hash_name(name)});
+}
+GLint program::attribute_location(hashed_name name) const {
+    program_reflection::attribute const* attribute = this->_reflection.find_attribute(name.hash);
+    return attribute != nullptr ? attribute->location : -1;
+}
+
+program::uniform_counters program::uniform_calls() const {
+    return this->_shadow.counters;
+}
+void program::reset_uniform_calls() {
+    this->_shadow.counters = {0, 0};
+}
+
+void program::build_uniform_shadow() {
+    this->_shadow.slots.clear();
+    this->_shadow.data.clear();
+    for(program_reflection::uniform const& uniform : this->_reflection.uniforms()) {
+        size_t element_size = glsl_type_size(uniform.type);
+        //Block members and opaque types without a size aren't shadowed,
+        //arrays are reflected twice ("values[0]" and "values") so skip locations already assigned
+        if(uniform.location < 0 || element_size == 0 ||
+           (size_t(uniform.location) < this->_shadow.slots.size() &&
+            this->_shadow.slots[uniform.location].element_size != 0)) {
+            continue;
+        }
+        std::uint32_t offset = static_cast<std::uint32_t>(this->_shadow.data.size());
+        std::uint32_t end = static_cast<std::uint32_t>(offset + element_size * uniform.array_size);
+        this->_shadow.data.resize(end);
+        size_t last_location = uniform.location + uniform.array_size;
+        if(this->_shadow.slots.size() < last_location) {
+            this->_shadow.slots.resize(last_location, {0, 0, 0, false});
+        }
+        for(GLint element = 0; element < uniform.array_size; element++) {
+            this->_shadow.slots[uniform.location + element] = {
+                static_cast<std::uint32_t>(offset + element * element_size),
+                end,
+                static_cast<std::uint32_t>(element_size),
+                false
+            };
+        }
+    }
+}
+bool program::shadow_unchanged(GLint loc, const void* data, size_t size, bool transpose) {
+    if(_bound == nullptr) {
+        return false;
+    }
+    uniform_shadow& shadow = _bound->_shadow;
+    //GL ignores location -1
+    if(loc < 0) {
+        shadow.counters.skipped++;
+        return true;
+    }
+    if(size_t(loc) >= shadow.slots.size() || shadow.slots[loc].element_size == 0 ||
+       shadow.slots[loc].offset + size > shadow.slots[loc].end) {
+        shadow.counters.issued++;
+        return false;
+    }
+
+    uniform_shadow::slot const& first = shadow.slots[loc];
+    size_t locations = (size + first.element_size - 1) / first.element_size;
+    bool valid = !transpose;
+    for(size_t element = 0; element < locations && valid; element++) {
+        valid = shadow.slots[loc + element].valid;
+    }
+    std::byte* shadowed = shadow.data.data() + first.offset;
+    if(valid && std::memcmp(shadowed, data, size) == 0) {
+        shadow.counters.skipped++;
+        return true;
+    }
+
+    //Transposed matrices are stored by GL in a different order than given, so they are never compared
+    std::memcpy(shadowed, data, size);
+    for(size_t element = 0; element < locations; element++) {
+        shadow.slots[loc + element].valid = !transpose;
+    }
+    shadow.counters.issued++;
+    return false;
+}
 
 STATIC_DEF(program::_bound_id)(0);
+STATIC_DEF(program::_bound)(nullptr);
 
 #pragma region uniforms
 
 //Vectors
 void program::bound::set_uniform(GLint loc, float const val) {
+    if(shadow_unchanged(loc, &val, sizeof(val))) {
+        return;
+    }
     glUniform1f(loc, val);
 }
 void program::bound::set_uniform(GLint loc, glm::fvec2 const& val) {
+    if(shadow_unchanged(loc, &val, sizeof(val))) {
+        return;
+    }
     glUniform2f(loc, val.x, val.y);
 }
 void program::bound::set_uniform(GLint loc, glm::fvec3 const& val) {
+    if(shadow_unchanged(loc, &val, sizeof(val))) {
+        return;
+    }
     glUniform3f(loc, val.x, val.y, val.z);
 }
 void program::bound::set_uniform(GLint loc, glm::fvec4 const& val) {
-    glUniform4f(loc, val.x, val.y, val.z, val.z);
+    if(shadow_unchanged(loc, &val, sizeof(val))) {
+        return;
+    }
+    glUniform4f(loc, val.x, val.y, val.z, val.w);
 }
 void program::bound::set_uniform(GLint loc, int const val) {
+    if(shadow_unchanged(loc, &val, sizeof(val))) {
+        return;
+    }
     glUniform1i(loc, val);
 }
 void program::bound::set_uniform(GLint loc, glm::ivec2 const& val) {
+    if(shadow_unchanged(loc, &val, sizeof(val))) {
+        return;
+    }
     glUniform2i(loc, val.x, val.y);
 }
 void program::bound::set_uniform(GLint loc, glm::ivec3 const& val) {
+    if(shadow_unchanged(loc, &val, sizeof(val))) {
+        return;
+    }
     glUniform3i(loc, val.x, val.y, val.z);
 }
 void program::bound::set_uniform(GLint loc, glm::ivec4 const& val) {
+    if(shadow_unchanged(loc, &val, sizeof(val))) {
+        return;
+    }
     glUniform4i(loc, val.x, val.y, val.z, val.w);
 }
 void program::bound::set_uniform(GLint loc, unsigned int const val) {
+    if(shadow_unchanged(loc, &val, sizeof(val))) {
+        return;
+    }
     glUniform1ui(loc, val);
 }
 void program::bound::set_uniform(GLint loc, glm::uvec2 const& val) {
+    if(shadow_unchanged(loc, &val, sizeof(val))) {
+        return;
+    }
     glUniform2ui(loc, val.x, val.y);
 }
 void program::bound::set_uniform(GLint loc, glm::uvec3 const& val) {
+    if(shadow_unchanged(loc, &val, sizeof(val))) {
+        return;
+    }
     glUniform3ui(loc, val.x, val.y, val.z);
 }
 void program::bound::set_uniform(GLint loc, glm::uvec4 const& val) {
+    if(shadow_unchanged(loc, &val, sizeof(val))) {
+        return;
+    }
     glUniform4ui(loc, val.x, val.y, val.z, val.w);
 }
 //Vector Arrays
 void program::bound::set_uniform(GLint loc, GLsizei count, float const* array) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count)) {
+        return;
+    }
     glUniform1fv(loc, count, array);
 }
 void program::bound::set_uniform(GLint loc, GLsizei count, glm::fvec2 const* array) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count)) {
+        return;
+    }
     glUniform2fv(loc, count, (float*)array);
 }
 void program::bound::set_uniform(GLint loc, GLsizei count, glm::fvec3 const* array) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count)) {
+        return;
+    }
     glUniform3fv(loc, count, (float*)array);
 }
 void program::bound::set_uniform(GLint loc, GLsizei count, glm::fvec4 const* array) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count)) {
+        return;
+    }
     glUniform4fv(loc, count, (float*)array);
 }
 void program::bound::set_uniform(GLint loc, GLsizei count, int const* array) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count)) {
+        return;
+    }
     glUniform1iv(loc, count, array);
 }
 void program::bound::set_uniform(GLint loc, GLsizei count, glm::ivec2 const* array) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count)) {
+        return;
+    }
     glUniform2iv(loc, count, (int*)array);
 }
 void program::bound::set_uniform(GLint loc, GLsizei count, glm::ivec3 const* array) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count)) {
+        return;
+    }
     glUniform3iv(loc, count, (int*)array);
 }
 void program::bound::set_uniform(GLint loc, GLsizei count, glm::ivec4 const* array) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count)) {
+        return;
+    }
     glUniform4iv(loc, count, (int*)array);
 }
 void program::bound::set_uniform(GLint loc, GLsizei count, unsigned int const* array) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count)) {
+        return;
+    }
     glUniform1uiv(loc, count, array);
 }
 void program::bound::set_uniform(GLint loc, GLsizei count, glm::uvec2 const* array) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count)) {
+        return;
+    }
     glUniform2uiv(loc, count, (unsigned int*)array);
 }
 void program::bound::set_uniform(GLint loc, GLsizei count, glm::uvec3 const* array) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count)) {
+        return;
+    }
     glUniform3uiv(loc, count, (unsigned int*)array);
 }
 void program::bound::set_uniform(GLint loc, GLsizei count, glm::uvec4 const* array) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count)) {
+        return;
+    }
     glUniform4uiv(loc, count, (unsigned int*)array);
 }
 //Matrices
 void program::bound::set_uniform(GLint loc, glm::mat2x2 const& val, bool transpose) {
+    if(shadow_unchanged(loc, &val, sizeof(val), transpose)) {
+        return;
+    }
     glUniformMatrix2fv(loc, 1, transpose, (float*)&val);
 }
 void program::bound::set_uniform(GLint loc, glm::mat3x3 const& val, bool transpose) {
+    if(shadow_unchanged(loc, &val, sizeof(val), transpose)) {
+        return;
+    }
     glUniformMatrix3fv(loc, 1, transpose, (float*)&val);
 }
 void program::bound::set_uniform(GLint loc, glm::mat4x4 const& val, bool transpose) {
+    if(shadow_unchanged(loc, &val, sizeof(val), transpose)) {
+        return;
+    }
     glUniformMatrix4fv(loc, 1, transpose, (float*)&val);
 }
 void program::bound::set_uniform(GLint loc, glm::mat2x3 const& val, bool transpose) {
+    if(shadow_unchanged(loc, &val, sizeof(val), transpose)) {
+        return;
+    }
     glUniformMatrix2x3fv(loc, 1, transpose, (float*)&val);
 }
 void program::bound::set_uniform(GLint loc, glm::mat3x2 const& val, bool transpose) {
+    if(shadow_unchanged(loc, &val, sizeof(val), transpose)) {
+        return;
+    }
     glUniformMatrix3x2fv(loc, 1, transpose, (float*)&val);
 }
 void program::bound::set_uniform(GLint loc, glm::mat2x4 const& val, bool transpose) {
+    if(shadow_unchanged(loc, &val, sizeof(val), transpose)) {
+        return;
+    }
     glUniformMatrix2x4fv(loc, 1, transpose, (float*)&val);
 }
 void program::bound::set_uniform(GLint loc, glm::mat4x2 const& val, bool transpose) {
+    if(shadow_unchanged(loc, &val, sizeof(val), transpose)) {
+        return;
+    }
     glUniformMatrix4x2fv(loc, 1, transpose, (float*)&val);
 }
 void program::bound::set_uniform(GLint loc, glm::mat3x4 const& val, bool transpose) {
+    if(shadow_unchanged(loc, &val, sizeof(val), transpose)) {
+        return;
+    }
     glUniformMatrix3x4fv(loc, 1, transpose, (float*)&val);
 }
 void program::bound::set_uniform(GLint loc, glm::mat4x3 const& val, bool transpose) {
+    if(shadow_unchanged(loc, &val, sizeof(val), transpose)) {
+        return;
+    }
     glUniformMatrix4x3fv(loc, 1, transpose, (float*)&val);
 }
 //Matrix Arrays
 void program::bound::set_uniform(GLint loc, GLsizei count, glm::mat2x2 const* array, bool transpose) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count, transpose)) {
+        return;
+    }
     glUniformMatrix2fv(loc, count, transpose, (float*)array);
 } 
 void program::bound::set_uniform(GLint loc, GLsizei count, glm::mat3x3 const* array, bool transpose) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count, transpose)) {
+        return;
+    }
     glUniformMatrix3fv(loc, count, transpose, (float*)array);
 } 
 void program::bound::set_uniform(GLint loc, GLsizei count, glm::mat4x4 const* array, bool transpose) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count, transpose)) {
+        return;
+    }
     glUniformMatrix4fv(loc, count, transpose, (float*)array);
 } 
 void program::bound::set_uniform(GLint loc, GLsizei count, glm::mat2x3 const* array, bool transpose) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count, transpose)) {
+        return;
+    }
     glUniformMatrix2x3fv(loc, count, transpose, (float*)array);
 } 
 void program::bound::set_uniform(GLint loc, GLsizei count, glm::mat3x2 const* array, bool transpose) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count, transpose)) {
+        return;
+    }
     glUniformMatrix3x2fv(loc, count, transpose, (float*)array);
 } 
 void program::bound::set_uniform(GLint loc, GLsizei count, glm::mat2x4 const* array, bool transpose) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count, transpose)) {
+        return;
+    }
     glUniformMatrix2x4fv(loc, count, transpose, (float*)array);
 } 
 void program::bound::set_uniform(GLint loc, GLsizei count, glm::mat4x2 const* array, bool transpose) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count, transpose)) {
+        return;
+    }
     glUniformMatrix4x2fv(loc, count, transpose, (float*)array);
 } 
 void program::bound::set_uniform(GLint loc, GLsizei count, glm::mat3x4 const* array, bool transpose) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count, transpose)) {
+        return;
+    }
     glUniformMatrix3x4fv(loc, count, transpose, (float*)array);
 } 
 void program::bound::set_uniform(GLint loc, GLsizei count, glm::mat4x3 const* array, bool transpose) {
+    if(shadow_unchanged(loc, array, sizeof(*array) * count, transpose)) {
+        return;
+    }
     glUniformMatrix4x3fv(loc, count, transpose, (float*)array);
 } 
 
@@ -278,7 +713,11 @@ void program::bound::set_uniform(GLint loc, GLsizei count, glm::mat4x3 const* ar
 #pragma region vertex_array 
 
 vertex_array::vertex_array() {
-    glGenVertexArrays(1, &this->_id);
+    if(direct_state_access()) {
+        glCreateVertexArrays(1, &this->_id);
+    } else {
+        glGenVertexArrays(1, &this->_id);
+    }
 }
 vertex_array::vertex_array(vertex_array&& move) noexcept
     : _id(move._id)
@@ -287,8 +726,12 @@ vertex_array::vertex_array(vertex_array&& move) noexcept
 }
 vertex_array::~vertex_array() {
     if(this->_id != 0) {
+        if(deletion_queue::defer(deletable_type::vertex_array, this->_id)) {
+            return;
+        }
         if(_bound_id == this->_id) {
             _bound_id = 0;
+            buffer::_bindings[buffer::target_slot(GL_ELEMENT_ARRAY_BUFFER)] = buffer::UNKNOWN_BINDING;
         }
         glDeleteVertexArrays(1, &this->_id);
     }
@@ -297,11 +740,80 @@ void vertex_array::bind() {
     if(_bound_id != this->_id) {
         glBindVertexArray(this->_id);
         _bound_id = this->_id;
+        buffer::_bindings[buffer::target_slot(GL_ELEMENT_ARRAY_BUFFER)] = buffer::UNKNOWN_BINDING;
     }
 }
 GLuint vertex_array::id() {
     return this->_id;
 }
+void vertex_array::enable_attrib(GLuint attrib) {
+    if(direct_state_access()) {
+        glEnableVertexArrayAttrib(this->_id, attrib);
+    } else {
+        this->bind();
+        glEnableVertexAttribArray(attrib);
+    }
+}
+void vertex_array::disable_attrib(GLuint attrib) {
+    if(direct_state_access()) {
+        glDisableVertexArrayAttrib(this->_id, attrib);
+    } else {
+        this->bind();
+        glDisableVertexAttribArray(attrib);
+    }
+}
+void vertex_array::attrib_format(GLuint attrib, GLint size, GLenum type, bool normalized, GLuint relative_offset) {
+    if(direct_state_access()) {
+        glVertexArrayAttribFormat(this->_id, attrib, size, type, normalized, relative_offset);
+    } else {
+        this->bind();
+        glVertexAttribFormat(attrib, size, type, normalized, relative_offset);
+    }
+}
+void vertex_array::attrib_i_format(GLuint attrib, GLint size, GLenum type, GLuint relative_offset) {
+    if(direct_state_access()) {
+        glVertexArrayAttribIFormat(this->_id, attrib, size, type, relative_offset);
+    } else {
+        this->bind();
+        glVertexAttribIFormat(attrib, size, type, relative_offset);
+    }
+}
+void vertex_array::attrib_binding(GLuint attrib, GLuint binding) {
+    if(direct_state_access()) {
+        glVertexArrayAttribBinding(this->_id, attrib, binding);
+    } else {
+        this->bind();
+        glVertexAttribBinding(attrib, binding);
+    }
+}
+void vertex_array::binding_divisor(GLuint binding, GLuint divisor) {
+    if(direct_state_access()) {
+        glVertexArrayBindingDivisor(this->_id, binding, divisor);
+    } else {
+        this->bind();
+        glVertexBindingDivisor(binding, divisor);
+    }
+}
+void vertex_array::vertex_buffer(GLuint binding, buffer& buf, GLintptr offset, GLsizei stride) {
+    if(direct_state_access()) {
+        glVertexArrayVertexBuffer(this->_id, binding, buf.id(), offset, stride);
+    } else {
+        this->bind();
+        glBindVertexBuffer(binding, buf.id(), offset, stride);
+    }
+}
+void vertex_array::element_buffer(buffer& buf) {
+    if(direct_state_access()) {
+        glVertexArrayElementBuffer(this->_id, buf.id());
+        //The element array binding is part of the bound vertex array's state
+        if(_bound_id == this->_id) {
+            buffer::_bindings[buffer::target_slot(GL_ELEMENT_ARRAY_BUFFER)] = buf.id();
+        }
+    } else {
+        this->bind();
+        buf.bind(GL_ELEMENT_ARRAY_BUFFER);
+    }
+}
 
 STATIC_DEF(vertex_array::_bound_id)(0);
 
@@ -319,19 +831,96 @@ query::query(query&& move) noexcept
 }
 query::~query() {
     if(this->_id != 0) {
+        if(deletion_queue::defer(deletable_type::query, this->_id)) {
+            return;
+        }
         glDeleteQueries(1, &this->_id);
     }
 }
+void query::begin(GLenum target) {
+    glBeginQuery(target, this->_id);
+}
+void query::end(GLenum target) {
+    glEndQuery(target);
+}
+void query::timestamp() {
+    glQueryCounter(this->_id, GL_TIMESTAMP);
+}
+bool query::result_available() {
+    GLuint available;
+    glGetQueryObjectuiv(this->_id, GL_QUERY_RESULT_AVAILABLE, &available);
+    return available != GL_FALSE;
+}
+GLuint64 query::result() {
+    GLuint64 value;
+    glGetQueryObjectui64v(this->_id, GL_QUERY_RESULT, &value);
+    return value;
+}
 GLuint query::id() {
     return this->_id;
 }
 
 #pragma endregion 
 
+#pragma region fence
+
+fence::fence() {
+    this->_sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+fence::fence(fence&& move) noexcept
+    : _sync(move._sync)
+{
+    move._sync = nullptr;
+}
+fence::~fence() {
+    if(this->_sync != nullptr) {
+        glDeleteSync(this->_sync);
+    }
+}
+bool fence::signaled() {
+    if(this->_sync == nullptr) {
+        return true;
+    }
+    GLint status;
+    glGetSynciv(this->_sync, GL_SYNC_STATUS, 1, nullptr, &status);
+    return status == GL_SIGNALED;
+}
+bool fence::client_wait(GLuint64 timeout_ns) {
+    if(this->_sync == nullptr) {
+        return true;
+    }
+    GLenum result = glClientWaitSync(this->_sync, GL_SYNC_FLUSH_COMMANDS_BIT, timeout_ns);
+    return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+}
+void fence::client_wait() {
+    if(this->_sync == nullptr) {
+        return;
+    }
+    //Only the first wait needs to flush
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while(glClientWaitSync(this->_sync, flags, 1000000) == GL_TIMEOUT_EXPIRED) {
+        flags = 0;
+    }
+}
+void fence::server_wait() {
+    if(this->_sync != nullptr) {
+        glWaitSync(this->_sync, 0, GL_TIMEOUT_IGNORED);
+    }
+}
+GLsync fence::id() {
+    return this->_sync;
+}
+
+#pragma endregion
+
 #pragma region program_pipeline 
 
 program_pipeline::program_pipeline() {
-    glGenProgramPipelines(1, &this->_id);
+    if(direct_state_access()) {
+        glCreateProgramPipelines(1, &this->_id);
+    } else {
+        glGenProgramPipelines(1, &this->_id);
+    }
 }
 program_pipeline::program_pipeline(program_pipeline&& move) noexcept
     : _id(move._id)
@@ -340,6 +929,9 @@ program_pipeline::program_pipeline(program_pipeline&& move) noexcept
 }
 program_pipeline::~program_pipeline() {
     if(this->_id != 0) {
+        if(deletion_queue::defer(deletable_type::program_pipeline, this->_id)) {
+            return;
+        }
         if(_bound_id == this->_id) {
             _bound_id = 0;
         }
@@ -363,7 +955,11 @@ STATIC_DEF(program_pipeline::_bound_id)(0);
 #pragma region transform_feedback
 
 transform_feedback::transform_feedback() {
-    glGenTransformFeedbacks(1, &this->_id);
+    if(direct_state_access()) {
+        glCreateTransformFeedbacks(1, &this->_id);
+    } else {
+        glGenTransformFeedbacks(1, &this->_id);
+    }
 }
 transform_feedback::transform_feedback(transform_feedback&& move) noexcept
     : _id(move._id)
@@ -372,6 +968,9 @@ transform_feedback::transform_feedback(transform_feedback&& move) noexcept
 }
 transform_feedback::~transform_feedback() {
     if(this->_id != 0) {
+        if(deletion_queue::defer(deletable_type::transform_feedback, this->_id)) {
+            return;
+        }
         if(_bound_id == this->_id) {
             _bound_id = 0;
         }
@@ -395,7 +994,11 @@ STATIC_DEF(transform_feedback::_bound_id)(0);
 #pragma region sampler
 
 sampler::sampler() {
-    glGenSamplers(1, &this->_id);
+    if(direct_state_access()) {
+        glCreateSamplers(1, &this->_id);
+    } else {
+        glGenSamplers(1, &this->_id);
+    }
 }
 sampler::sampler(sampler&& move) noexcept
     : _id(move._id)
@@ -404,6 +1007,9 @@ sampler::sampler(sampler&& move) noexcept
 }
 sampler::~sampler() {
     if(this->_id != 0) {
+        if(deletion_queue::defer(deletable_type::sampler, this->_id)) {
+            return;
+        }
         for(size_t index = 0; index < GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS; index++) {
             if(_bindings[index] == this->_id) {
                 _bindings[index] = 0;
@@ -421,17 +1027,221 @@ void sampler::bind(GLuint unit) {
 GLuint sampler::id() {
     return this->_id;
 }
+void sampler::parameter(GLenum pname, GLint value) {
+    glSamplerParameteri(this->_id, pname, value);
+}
+void sampler::parameter(GLenum pname, GLfloat value) {
+    glSamplerParameterf(this->_id, pname, value);
+}
 
 STATIC_DEF(sampler::_bindings){0};
 
 #pragma endregion
 
-//textures are defined in header due to template definitions
+#pragma region any_texture
+
+//Inverse of any_texture::target_slot
+constexpr GLenum TEXTURE_TARGETS[any_texture::TARGET_COUNT] = {
+    GL_TEXTURE_1D, GL_TEXTURE_2D, GL_TEXTURE_3D,
+    GL_TEXTURE_1D_ARRAY, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_RECTANGLE,
+    GL_TEXTURE_CUBE_MAP, GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_BUFFER,
+    GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_2D_MULTISAMPLE_ARRAY
+};
+
+any_texture::any_texture(GLenum target)
+    : _target(target)
+{
+    if(direct_state_access()) {
+        glCreateTextures(target, 1, &this->_id);
+    } else {
+        glGenTextures(1, &this->_id);
+    }
+}
+any_texture::any_texture(any_texture&& move) noexcept
+    : _id(move._id),
+      _target(move._target)
+{
+    move._id = 0;
+}
+any_texture::~any_texture() {
+    if(this->_id != 0) {
+        if(deletion_queue::defer(deletable_type::texture, this->_id)) {
+            return;
+        }
+        size_t slot = target_slot(this->_target);
+        for(GLuint unit = 0; unit < MAX_CACHED_UNITS; unit++) {
+            if(_bindings[unit][slot] == this->_id) {
+                _bindings[unit][slot] = 0;
+            }
+        }
+        glDeleteTextures(1, &this->_id);
+    }
+}
+void any_texture::bind() {
+    GLuint unit = _active_unit;
+    if(unit < MAX_CACHED_UNITS) {
+        GLuint& bound = _bindings[unit][target_slot(this->_target)];
+        if(bound == this->_id) {
+            return;
+        }
+        bound = this->_id;
+    }
+    glBindTexture(this->_target, this->_id);
+}
+void any_texture::bind(GLuint unit) {
+    if(unit < MAX_CACHED_UNITS) {
+        GLuint& bound = _bindings[unit][target_slot(this->_target)];
+        if(bound == this->_id) {
+            return;
+        }
+        if(direct_state_access()) {
+            //Does not disturb the active unit
+            glBindTextureUnit(unit, this->_id);
+            bound = this->_id;
+            return;
+        }
+    }
+    active_unit(unit);
+    this->bind();
+}
+GLuint any_texture::id() {
+    return this->_id;
+}
+void any_texture::active_unit(GLuint unit) {
+    if(_active_unit != unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        _active_unit = unit;
+    }
+}
+
+STATIC_DEF(any_texture::_active_unit)(0);
+STATIC_DEF(any_texture::_bindings){};
+
+//Largest number of units submitted per glBindTextures/glBindSamplers call
+constexpr size_t MULTI_BIND_CHUNK = 32;
+
+void bind_textures(GLuint first_unit, std::span<any_texture* const> textures) {
+    auto is_bound = [&](size_t index) {
+        GLuint unit = first_unit + static_cast<GLuint>(index);
+        if(unit >= any_texture::MAX_CACHED_UNITS) {
+            return false;
+        }
+        GLuint* row = any_texture::_bindings[unit];
+        any_texture* tex = textures[index];
+        if(tex != nullptr) {
+            return row[any_texture::target_slot(tex->_target)] == tex->_id;
+        }
+        for(size_t slot = 0; slot < any_texture::TARGET_COUNT; slot++) {
+            if(row[slot] != 0) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    size_t first_dirty = textures.size();
+    size_t last_dirty = 0;
+    for(size_t index = 0; index < textures.size(); index++) {
+        if(!is_bound(index)) {
+            first_dirty = std::min(first_dirty, index);
+            last_dirty = index;
+        }
+    }
+    if(first_dirty == textures.size()) {
+        return;
+    }
+
+    if(multi_bind()) {
+        GLuint names[MULTI_BIND_CHUNK];
+        for(size_t begin = first_dirty; begin <= last_dirty; begin += MULTI_BIND_CHUNK) {
+            size_t count = std::min(MULTI_BIND_CHUNK, last_dirty + 1 - begin);
+            for(size_t index = 0; index < count; index++) {
+                any_texture* tex = textures[begin + index];
+                names[index] = tex != nullptr ? tex->_id : 0;
+            }
+            glBindTextures(first_unit + static_cast<GLuint>(begin), static_cast<GLsizei>(count), names);
+        }
+    } else {
+        for(size_t index = first_dirty; index <= last_dirty; index++) {
+            GLuint unit = first_unit + static_cast<GLuint>(index);
+            any_texture* tex = textures[index];
+            if(tex != nullptr) {
+                tex->bind(unit);
+                continue;
+            }
+            any_texture::active_unit(unit);
+            for(size_t slot = 0; slot < any_texture::TARGET_COUNT; slot++) {
+                if(unit >= any_texture::MAX_CACHED_UNITS || any_texture::_bindings[unit][slot] != 0) {
+                    glBindTexture(TEXTURE_TARGETS[slot], 0);
+                }
+            }
+        }
+    }
+
+    for(size_t index = first_dirty; index <= last_dirty; index++) {
+        GLuint unit = first_unit + static_cast<GLuint>(index);
+        if(unit >= any_texture::MAX_CACHED_UNITS) {
+            break;
+        }
+        GLuint* row = any_texture::_bindings[unit];
+        any_texture* tex = textures[index];
+        if(tex != nullptr) {
+            row[any_texture::target_slot(tex->_target)] = tex->_id;
+        } else {
+            std::fill(row, row + any_texture::TARGET_COUNT, 0);
+        }
+    }
+}
+
+void bind_samplers(GLuint first_unit, std::span<sampler* const> samplers) {
+    constexpr size_t CACHED_UNITS = std::size(sampler::_bindings);
+
+    size_t first_dirty = samplers.size();
+    size_t last_dirty = 0;
+    for(size_t index = 0; index < samplers.size(); index++) {
+        size_t unit = first_unit + index;
+        GLuint name = samplers[index] != nullptr ? samplers[index]->_id : 0;
+        if(unit >= CACHED_UNITS || sampler::_bindings[unit] != name) {
+            first_dirty = std::min(first_dirty, index);
+            last_dirty = index;
+        }
+    }
+    if(first_dirty == samplers.size()) {
+        return;
+    }
+
+    if(multi_bind()) {
+        GLuint names[MULTI_BIND_CHUNK];
+        for(size_t begin = first_dirty; begin <= last_dirty; begin += MULTI_BIND_CHUNK) {
+            size_t count = std::min(MULTI_BIND_CHUNK, last_dirty + 1 - begin);
+            for(size_t index = 0; index < count; index++) {
+                sampler* samp = samplers[begin + index];
+                names[index] = samp != nullptr ? samp->_id : 0;
+            }
+            glBindSamplers(first_unit + static_cast<GLuint>(begin), static_cast<GLsizei>(count), names);
+        }
+    } else {
+        for(size_t index = first_dirty; index <= last_dirty; index++) {
+            sampler* samp = samplers[index];
+            glBindSampler(first_unit + static_cast<GLuint>(index), samp != nullptr ? samp->_id : 0);
+        }
+    }
+
+    for(size_t index = first_dirty; index <= last_dirty && first_unit + index < CACHED_UNITS; index++) {
+        sampler::_bindings[first_unit + index] = samplers[index] != nullptr ? samplers[index]->_id : 0;
+    }
+}
+
+#pragma endregion
 
 #pragma region renderbuffer
 
 renderbuffer::renderbuffer() {
-    glGenRenderbuffers(1, &this->_id);
+    if(direct_state_access()) {
+        glCreateRenderbuffers(1, &this->_id);
+    } else {
+        glGenRenderbuffers(1, &this->_id);
+    }
 }
 renderbuffer::renderbuffer(renderbuffer&& move) noexcept
     : _id(move._id)
@@ -440,6 +1250,9 @@ renderbuffer::renderbuffer(renderbuffer&& move) noexcept
 }
 renderbuffer::~renderbuffer() {
     if(this->_id != 0) {
+        if(deletion_queue::defer(deletable_type::renderbuffer, this->_id)) {
+            return;
+        }
         if(_bound_id == this->_id) {
             _bound_id = 0;
         }
@@ -455,6 +1268,22 @@ void renderbuffer::bind() {
 GLuint renderbuffer::id() {
     return this->_id;
 }
+void renderbuffer::storage(GLenum internal_format, GLsizei width, GLsizei height) {
+    if(direct_state_access()) {
+        glNamedRenderbufferStorage(this->_id, internal_format, width, height);
+    } else {
+        this->bind();
+        glRenderbufferStorage(GL_RENDERBUFFER, internal_format, width, height);
+    }
+}
+void renderbuffer::storage_multisample(GLsizei samples, GLenum internal_format, GLsizei width, GLsizei height) {
+    if(direct_state_access()) {
+        glNamedRenderbufferStorageMultisample(this->_id, samples, internal_format, width, height);
+    } else {
+        this->bind();
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, internal_format, width, height);
+    }
+}
 
 STATIC_DEF(renderbuffer::_bound_id)(0);
 
@@ -463,7 +1292,11 @@ STATIC_DEF(renderbuffer::_bound_id)(0);
 #pragma region framebuffer
 
 framebuffer::framebuffer() {
-    glGenFramebuffers(1, &this->_id);
+    if(direct_state_access()) {
+        glCreateFramebuffers(1, &this->_id);
+    } else {
+        glGenFramebuffers(1, &this->_id);
+    }
 }
 framebuffer::framebuffer(framebuffer&& move) noexcept
     : _id(move._id)
@@ -472,6 +1305,9 @@ framebuffer::framebuffer(framebuffer&& move) noexcept
 }
 framebuffer::~framebuffer() {
     if(this->_id != 0) {
+        if(deletion_queue::defer(deletable_type::framebuffer, this->_id)) {
+            return;
+        }
         if(_read_bound_id == this->_id) {
             _read_bound_id = 0;
         }
@@ -504,6 +1340,70 @@ GLuint framebuffer::id() {
     return this->_id;
 }
 
+void framebuffer::attach(GLenum attachment, any_texture& texture, GLint level) {
+    if(direct_state_access()) {
+        glNamedFramebufferTexture(this->_id, attachment, texture.id(), level);
+    } else {
+        this->bind();
+        glFramebufferTexture(GL_FRAMEBUFFER, attachment, texture.id(), level);
+    }
+}
+void framebuffer::attach_layer(GLenum attachment, any_texture& texture, GLint level, GLint layer) {
+    if(direct_state_access()) {
+        glNamedFramebufferTextureLayer(this->_id, attachment, texture.id(), level, layer);
+    } else {
+        this->bind();
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, attachment, texture.id(), level, layer);
+    }
+}
+void framebuffer::attach(GLenum attachment, renderbuffer& buffer) {
+    if(direct_state_access()) {
+        glNamedFramebufferRenderbuffer(this->_id, attachment, GL_RENDERBUFFER, buffer.id());
+    } else {
+        this->bind();
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, buffer.id());
+    }
+}
+void framebuffer::detach(GLenum attachment) {
+    if(direct_state_access()) {
+        glNamedFramebufferTexture(this->_id, attachment, 0, 0);
+    } else {
+        this->bind();
+        glFramebufferTexture(GL_FRAMEBUFFER, attachment, 0, 0);
+    }
+}
+void framebuffer::draw_buffers(std::span<const GLenum> attachments) {
+    if(direct_state_access()) {
+        glNamedFramebufferDrawBuffers(this->_id, static_cast<GLsizei>(attachments.size()), attachments.data());
+    } else {
+        this->bind_write();
+        glDrawBuffers(static_cast<GLsizei>(attachments.size()), attachments.data());
+    }
+}
+void framebuffer::read_buffer(GLenum attachment) {
+    if(direct_state_access()) {
+        glNamedFramebufferReadBuffer(this->_id, attachment);
+    } else {
+        this->bind_read();
+        glReadBuffer(attachment);
+    }
+}
+GLenum framebuffer::status() {
+    if(direct_state_access()) {
+        return glCheckNamedFramebufferStatus(this->_id, GL_DRAW_FRAMEBUFFER);
+    }
+    this->bind_write();
+    return glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER);
+}
+void framebuffer::invalidate(std::span<const GLenum> attachments) {
+    if(direct_state_access()) {
+        glInvalidateNamedFramebufferData(this->_id, static_cast<GLsizei>(attachments.size()), attachments.data());
+    } else {
+        this->bind_write();
+        glInvalidateFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLsizei>(attachments.size()), attachments.data());
+    }
+}
+
 framebuffer::framebuffer(GLuint id) : _id(id) {}
 
 STATIC_DEF(framebuffer::DEFAULT)(0);
@@ -512,4 +1412,29 @@ STATIC_DEF(framebuffer::_draw_bound_id)(0);
 
 #pragma endregion
 
+#pragma region forget_thread_bindings
+
+void forget_thread_bindings() {
+    //UNKNOWN_BINDING never matches a real name, every cached compare fails until the next bind
+    constexpr GLuint UNKNOWN = buffer::UNKNOWN_BINDING;
+    std::fill(std::begin(buffer::_bindings), std::end(buffer::_bindings), UNKNOWN);
+    for(auto& target : buffer::_indexed_bindings) {
+        std::fill(std::begin(target), std::end(target), buffer::indexed_binding{UNKNOWN, 0, 0});
+    }
+    program::_bound_id = UNKNOWN;
+    program::_bound = nullptr;
+    vertex_array::_bound_id = UNKNOWN;
+    program_pipeline::_bound_id = UNKNOWN;
+    transform_feedback::_bound_id = UNKNOWN;
+    std::fill(std::begin(sampler::_bindings), std::end(sampler::_bindings), UNKNOWN);
+    for(auto& unit : any_texture::_bindings) {
+        std::fill(std::begin(unit), std::end(unit), UNKNOWN);
+    }
+    renderbuffer::_bound_id = UNKNOWN;
+    framebuffer::_read_bound_id = UNKNOWN;
+    framebuffer::_draw_bound_id = UNKNOWN;
+}
+
+#pragma endregion
+
 }
\ No newline at end of file
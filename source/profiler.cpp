@@ -0,0 +1,145 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#include<utility>
+
+#include "agl/profiler.hpp"
+
+namespace agl {
+
+#pragma region gpu_profiler
+
+gpu_profiler::gpu_profiler(GLuint latency, GLuint max_zones_per_frame, size_t history_size)
+    : _slots(latency > 0 ? latency : 1),
+      _max_zones(max_zones_per_frame),
+      _history_size(history_size),
+      _frame(0),
+      _dropped_frames(0),
+      _recording(false)
+{}
+
+void gpu_profiler::begin_frame() {
+    //Oldest slot first, the GPU retires frames in order so stop at the first unfinished one
+    for(size_t offset = 0; offset < this->_slots.size(); offset++) {
+        frame_slot& slot = this->_slots[(this->_frame + offset) % this->_slots.size()];
+        if(slot.pending) {
+            this->resolve(slot);
+            if(slot.pending) {
+                break;
+            }
+        }
+    }
+
+    frame_slot& slot = this->_slots[this->_frame % this->_slots.size()];
+    if(slot.pending) {
+        slot.pending = false;
+        this->_dropped_frames++;
+    }
+    slot.zones.clear();
+    slot.used_queries = 0;
+    slot.index = this->_frame;
+
+    this->_open_zones.clear();
+    this->_recording = true;
+    this->begin_zone("frame");
+}
+void gpu_profiler::end_frame() {
+    while(!this->_open_zones.empty()) {
+        this->end_zone();
+    }
+    this->_recording = false;
+
+    frame_slot& slot = this->_slots[this->_frame % this->_slots.size()];
+    slot.pending = !slot.zones.empty();
+    this->_frame++;
+}
+
+void gpu_profiler::begin_zone(const char* name) {
+    frame_slot& slot = this->_slots[this->_frame % this->_slots.size()];
+    //Zones outside of a frame or past the per-frame limit are tracked only to keep begin/end balanced
+    if(!this->_recording || slot.zones.size() >= this->_max_zones) {
+        this->_open_zones.push_back(-1);
+        return;
+    }
+    GLint parent = this->_open_zones.empty() ? -1 : this->_open_zones.back();
+    GLuint depth = parent < 0 ? 0 : slot.zones[parent].depth + 1;
+    slot.zones.push_back({name, depth, parent, this->next_query(slot), 0});
+    this->_open_zones.push_back(static_cast<GLint>(slot.zones.size() - 1));
+}
+void gpu_profiler::end_zone() {
+    if(this->_open_zones.empty()) {
+        return;
+    }
+    GLint index = this->_open_zones.back();
+    this->_open_zones.pop_back();
+    if(index >= 0) {
+        frame_slot& slot = this->_slots[this->_frame % this->_slots.size()];
+        slot.zones[index].end_query = this->next_query(slot);
+    }
+}
+
+gpu_profiler::frame const* gpu_profiler::latest() const {
+    return this->_history.empty() ? nullptr : &this->_history.back();
+}
+std::deque<gpu_profiler::frame> const& gpu_profiler::history() const {
+    return this->_history;
+}
+std::uint64_t gpu_profiler::dropped_frames() const {
+    return this->_dropped_frames;
+}
+
+void gpu_profiler::write_chrome_trace(std::ostream& out) const {
+    GLuint64 base_ns = this->_history.empty() ? 0 : this->_history.front().zones.front().begin_ns;
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for(frame const& resolved : this->_history) {
+        for(zone const& z : resolved.zones) {
+            out << (first ? "\n" : ",\n");
+            first = false;
+            out << "{\"name\":\"";
+            for(const char* c = z.name; *c != '\0'; c++) {
+                if(*c == '"' || *c == '\\') {
+                    out << '\\';
+                }
+                out << *c;
+            }
+            out << "\",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":0,\"tid\":0"
+                << ",\"ts\":" << double(z.begin_ns - base_ns) / 1000.0
+                << ",\"dur\":" << double(z.end_ns - z.begin_ns) / 1000.0
+                << ",\"args\":{\"frame\":" << resolved.index << "}}";
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+GLuint gpu_profiler::next_query(frame_slot& slot) {
+    if(slot.used_queries == slot.queries.size()) {
+        slot.queries.emplace_back();
+    }
+    slot.queries[slot.used_queries].timestamp();
+    return slot.used_queries++;
+}
+void gpu_profiler::resolve(frame_slot& slot) {
+    //Queries complete in order, so the last one being available means they all are
+    if(slot.used_queries > 0 && !slot.queries[slot.used_queries - 1].result_available()) {
+        return;
+    }
+    slot.pending = false;
+
+    frame resolved{slot.index, {}};
+    resolved.zones.reserve(slot.zones.size());
+    for(pending_zone const& z : slot.zones) {
+        resolved.zones.push_back({
+            z.name, z.depth, z.parent,
+            slot.queries[z.begin_query].result(),
+            slot.queries[z.end_query].result()
+        });
+    }
+    this->_history.push_back(std::move(resolved));
+    while(this->_history.size() > this->_history_size) {
+        this->_history.pop_front();
+    }
+}
+
+#pragma endregion
+
+}
@@ -0,0 +1,132 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#define AGL_SHADER_ACCESS
+#define AGL_PROGRAM_ACCESS
+
+#include<utility>
+#include<algorithm>
+
+#include "agl/program_builder.hpp"
+
+namespace agl {
+
+struct program_build {
+    program prog;
+    std::vector<dynamic_shader> shaders;
+    program_future::state state = program_future::state::pending;
+    std::string log;
+};
+
+#pragma region program_future
+
+bool program_future::valid() const {
+    return this->_build != nullptr;
+}
+program_future::state program_future::status() const {
+    return this->_build->state;
+}
+bool program_future::ready() const {
+    return this->_build->state != state::pending;
+}
+program& program_future::get() {
+    return this->_build->prog;
+}
+std::string const& program_future::info_log() const {
+    return this->_build->log;
+}
+
+#pragma endregion
+
+#pragma region program_builder
+
+//Link status is final here, reflects or gathers the logs and releases the shaders
+static void resolve(program_build& build) {
+    if(build.prog.link_success()) {
+        build.prog.reflect();
+        build.state = program_future::state::linked;
+    } else {
+        for(dynamic_shader& shader : build.shaders) {
+            if(!shader.compile_success()) {
+                build.log += shader.info_log();
+            }
+        }
+        build.log += build.prog.info_log();
+        build.state = program_future::state::failed;
+    }
+    for(dynamic_shader& shader : build.shaders) {
+        build.prog.detach_shader(shader);
+    }
+    build.shaders.clear();
+}
+
+program_builder::program_builder(GLuint max_threads) {
+    if(parallel_shader_compile()) {
+        if(GLAD_GL_KHR_parallel_shader_compile) {
+            glMaxShaderCompilerThreadsKHR(max_threads);
+        } else {
+            glMaxShaderCompilerThreadsARB(max_threads);
+        }
+    }
+}
+program_builder::program_builder(program_builder&& move) noexcept
+    : _pending(std::move(move._pending))
+{}
+program_builder::~program_builder() {
+    this->finish_all();
+}
+
+program_future program_builder::submit(std::span<const shader_source> sources, std::string_view defines) {
+    auto build = std::make_shared<program_build>();
+    build->shaders.reserve(sources.size());
+    for(shader_source const& source : sources) {
+        dynamic_shader& shader = build->shaders.emplace_back(source.type);
+        if(defines.empty()) {
+            shader.compile(source.source);
+        } else {
+            shader.compile(source.source, defines);
+        }
+        build->prog.attach_shader(shader);
+    }
+    //program::link would query the link status and wait for the compiler
+    glLinkProgram(build->prog.id());
+    this->_pending.push_back(build);
+
+    program_future future;
+    future._build = std::move(build);
+    return future;
+}
+
+size_t program_builder::poll(size_t blocking_budget) {
+    bool parallel = parallel_shader_compile();
+    size_t resolved = 0;
+    auto end = std::remove_if(this->_pending.begin(), this->_pending.end(),
+        [&](std::shared_ptr<program_build> const& build) {
+            if(parallel) {
+                GLint complete = GL_FALSE;
+                glGetProgramiv(build->prog.id(), GL_COMPLETION_STATUS_KHR, &complete);
+                if(complete == GL_FALSE) {
+                    return false;
+                }
+            } else if(resolved >= blocking_budget) {
+                return false;
+            }
+            resolve(*build);
+            resolved++;
+            return true;
+        });
+    this->_pending.erase(end, this->_pending.end());
+    return resolved;
+}
+void program_builder::finish_all() {
+    for(std::shared_ptr<program_build> const& build : this->_pending) {
+        resolve(*build);
+    }
+    this->_pending.clear();
+}
+size_t program_builder::pending() const {
+    return this->_pending.size();
+}
+
+#pragma endregion
+
+}
@@ -0,0 +1,326 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#define AGL_GL_OBJECT_ACCESS
+#define AGL_SHADER_ACCESS
+#define AGL_PROGRAM_ACCESS
+
+#include<iostream>
+#include<fstream>
+#include<filesystem>
+#include<utility>
+#include<cstring>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include<windows.h>
+#else
+    #include<sys/mman.h>
+    #include<sys/stat.h>
+    #include<fcntl.h>
+    #include<unistd.h>
+#endif
+
+#include "agl/program_cache.hpp"
+
+namespace agl {
+
+#pragma region program_cache
+
+//Archive layout: header, entry table, then the binaries (native endianness, the archive never
+//leaves the machine that wrote it)
+constexpr char ARCHIVE_MAGIC[4] = {'A', 'G', 'L', 'P'};
+constexpr std::uint32_t ARCHIVE_VERSION = 1;
+
+struct archive_header {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t entry_count;
+};
+struct archive_entry {
+    std::uint64_t key;
+    std::uint32_t format;
+    std::uint32_t reserved;
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+//FNV-1a continued from a previous hash, the length is mixed in so part boundaries matter
+static std::uint64_t hash_append(std::uint64_t hash, std::string_view part) {
+    for(char c : part) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    size_t length = part.length();
+    for(size_t byte = 0; byte < sizeof(length); byte++) {
+        hash ^= (length >> (byte * 8)) & 0xFF;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+program_cache::program_cache(std::string path)
+    : _path(std::move(path)),
+      _binaries_supported(false),
+      _dirty(false),
+      _mapping(nullptr),
+      _mapping_size(0),
+      _stats{0, 0, 0}
+{
+    GLint format_count = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+    this->_binaries_supported = format_count > 0;
+
+    const GLubyte* renderer = glGetString(GL_RENDERER);
+    const GLubyte* version = glGetString(GL_VERSION);
+    this->_driver.append(renderer != nullptr ? reinterpret_cast<const char*>(renderer) : "");
+    this->_driver.push_back('\n');
+    this->_driver.append(version != nullptr ? reinterpret_cast<const char*>(version) : "");
+
+    if(this->_binaries_supported) {
+        this->map_archive();
+    }
+}
+program_cache::program_cache(program_cache&& move) noexcept
+    : _path(std::move(move._path)),
+      _driver(std::move(move._driver)),
+      _binaries_supported(move._binaries_supported),
+      _dirty(move._dirty),
+      _mapping(move._mapping),
+      _mapping_size(move._mapping_size),
+      _records(std::move(move._records)),
+      _stats(move._stats)
+{
+    move._dirty = false;
+    move._mapping = nullptr;
+    move._mapping_size = 0;
+}
+program_cache::~program_cache() {
+    if(this->_dirty) {
+        this->save();
+    }
+    this->_records.clear();
+    this->unmap_archive();
+}
+
+bool program_cache::link(program& prog, std::span<const shader_source> sources, std::string_view defines) {
+    if(!this->_binaries_supported) {
+        this->_stats.misses++;
+        return this->link_from_source(prog, sources, defines);
+    }
+
+    std::uint64_t hash = this->key(sources, defines);
+    auto found = this->_records.find(hash);
+    if(found != this->_records.end()) {
+        if(prog.load_binary(found->second.format, found->second.binary)) {
+            this->_stats.hits++;
+            return true;
+        }
+        this->_stats.rejected++;
+        this->_records.erase(found);
+        this->_dirty = true;
+    }
+
+    this->_stats.misses++;
+    if(!this->link_from_source(prog, sources, defines)) {
+        return false;
+    }
+    record added{};
+    added.owned = prog.get_binary(added.format);
+    if(!added.owned.empty()) {
+        added.binary = added.owned;
+        this->_records.insert_or_assign(hash, std::move(added));
+        this->_dirty = true;
+    }
+    return true;
+}
+
+bool program_cache::save() {
+    if(!this->_dirty) {
+        return true;
+    }
+
+    std::string temp_path = this->_path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if(!file) {
+            #ifndef NDEBUG
+            std::cerr << "Error: Failed to write program cache \"" << temp_path << "\"!" << std::endl;
+            #endif
+            return false;
+        }
+
+        archive_header header{};
+        std::memcpy(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+        header.version = ARCHIVE_VERSION;
+        header.entry_count = this->_records.size();
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        std::uint64_t offset = sizeof(archive_header) + sizeof(archive_entry) * this->_records.size();
+        for(auto const& [hash, rec] : this->_records) {
+            archive_entry entry{hash, rec.format, 0, offset, rec.binary.size()};
+            file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+            offset += rec.binary.size();
+        }
+        for(auto const& [hash, rec] : this->_records) {
+            file.write(reinterpret_cast<const char*>(rec.binary.data()), rec.binary.size());
+        }
+        if(!file) {
+            return false;
+        }
+    }
+
+    //The old mapping has to be released before it can be replaced (Windows), records still pointing into it
+    //are copied so nothing is lost if the rename fails
+    for(auto& [hash, rec] : this->_records) {
+        if(rec.owned.empty()) {
+            rec.owned.assign(rec.binary.begin(), rec.binary.end());
+            rec.binary = rec.owned;
+        }
+    }
+    this->unmap_archive();
+    std::error_code error;
+    std::filesystem::rename(temp_path, this->_path, error);
+    if(error) {
+        #ifndef NDEBUG
+        std::cerr << "Error: Failed to replace program cache \"" << this->_path << "\": " << error.message() << std::endl;
+        #endif
+        std::filesystem::remove(temp_path, error);
+        return false;
+    }
+    this->_records.clear();
+    this->map_archive();
+    this->_dirty = false;
+    return true;
+}
+void program_cache::clear() {
+    this->_dirty = this->_dirty || !this->_records.empty();
+    this->_records.clear();
+}
+
+program_cache::statistics program_cache::stats() const {
+    return this->_stats;
+}
+size_t program_cache::entry_count() const {
+    return this->_records.size();
+}
+bool program_cache::binaries_supported() const {
+    return this->_binaries_supported;
+}
+
+std::uint64_t program_cache::key(std::span<const shader_source> sources, std::string_view defines) const {
+    std::uint64_t hash = hash_append(hash_name(this->_driver), defines);
+    for(shader_source const& source : sources) {
+        hash = hash_append(hash, std::string_view(reinterpret_cast<const char*>(&source.type), sizeof(source.type)));
+        hash = hash_append(hash, source.source);
+    }
+    return hash;
+}
+
+bool program_cache::link_from_source(program& prog, std::span<const shader_source> sources, std::string_view defines) {
+    std::vector<dynamic_shader> shaders;
+    shaders.reserve(sources.size());
+    bool compiled = true;
+    for(shader_source const& source : sources) {
+        dynamic_shader& shader = shaders.emplace_back(source.type);
+        shader.compile(source.source, defines);
+        if(!shader.compile_success()) {
+            compiled = false;
+            #ifndef NDEBUG
+            std::cerr << "Error: Shader compilation failed!\n" << shader.info_log() << std::endl;
+            #endif
+        }
+        prog.attach_shader(shader);
+    }
+
+    if(compiled) {
+        glProgramParameteri(prog.id(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        prog.link();
+    }
+    for(dynamic_shader& shader : shaders) {
+        prog.detach_shader(shader);
+    }
+    return compiled && prog.link_success();
+}
+
+void program_cache::map_archive() {
+    #ifdef _WIN32
+    HANDLE file = CreateFileA(this->_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    LARGE_INTEGER file_size;
+    if(GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if(mapping != nullptr) {
+            this->_mapping = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            this->_mapping_size = this->_mapping != nullptr ? static_cast<size_t>(file_size.QuadPart) : 0;
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+    #else
+    int file = open(this->_path.c_str(), O_RDONLY);
+    if(file < 0) {
+        return;
+    }
+    struct stat file_stat;
+    if(fstat(file, &file_stat) == 0 && file_stat.st_size > 0) {
+        void* mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if(mapping != MAP_FAILED) {
+            this->_mapping = static_cast<const std::byte*>(mapping);
+            this->_mapping_size = file_stat.st_size;
+        }
+    }
+    close(file);
+    #endif
+
+    if(this->_mapping == nullptr) {
+        return;
+    }
+
+    archive_header header;
+    bool valid = this->_mapping_size >= sizeof(header);
+    if(valid) {
+        std::memcpy(&header, this->_mapping, sizeof(header));
+        valid = std::memcmp(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) == 0
+            && header.version == ARCHIVE_VERSION
+            && header.entry_count <= (this->_mapping_size - sizeof(header)) / sizeof(archive_entry);
+    }
+    for(std::uint64_t index = 0; valid && index < header.entry_count; index++) {
+        archive_entry entry;
+        std::memcpy(&entry, this->_mapping + sizeof(header) + index * sizeof(entry), sizeof(entry));
+        if(entry.offset > this->_mapping_size || entry.size > this->_mapping_size - entry.offset) {
+            valid = false;
+            break;
+        }
+        record rec{};
+        rec.format = entry.format;
+        rec.binary = std::span<const std::byte>(this->_mapping + entry.offset, entry.size);
+        this->_records.insert_or_assign(entry.key, std::move(rec));
+    }
+    if(!valid) {
+        #ifndef NDEBUG
+        std::cerr << "Warning: Ignoring corrupt program cache \"" << this->_path << "\"!" << std::endl;
+        #endif
+        this->_records.clear();
+        this->unmap_archive();
+        this->_dirty = true;
+    }
+}
+void program_cache::unmap_archive() {
+    if(this->_mapping == nullptr) {
+        return;
+    }
+    #ifdef _WIN32
+    UnmapViewOfFile(this->_mapping);
+    #else
+    munmap(const_cast<std::byte*>(this->_mapping), this->_mapping_size);
+    #endif
+    this->_mapping = nullptr;
+    this->_mapping_size = 0;
+}
+
+#pragma endregion
+
+}
@@ -0,0 +1,196 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#include<iostream>
+#include<algorithm>
+#include<utility>
+
+#include "agl/readback.hpp"
+
+namespace agl {
+
+GLsizei pixel_size(GLenum format, GLenum type) {
+    //Packed types describe the whole pixel
+    switch(type) {
+        case GL_UNSIGNED_BYTE_3_3_2:
+        case GL_UNSIGNED_BYTE_2_3_3_REV:
+            return 1;
+        case GL_UNSIGNED_SHORT_5_6_5:
+        case GL_UNSIGNED_SHORT_5_6_5_REV:
+        case GL_UNSIGNED_SHORT_4_4_4_4:
+        case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+        case GL_UNSIGNED_SHORT_5_5_5_1:
+        case GL_UNSIGNED_SHORT_1_5_5_5_REV:
+            return 2;
+        case GL_UNSIGNED_INT_8_8_8_8:
+        case GL_UNSIGNED_INT_8_8_8_8_REV:
+        case GL_UNSIGNED_INT_10_10_10_2:
+        case GL_UNSIGNED_INT_2_10_10_10_REV:
+        case GL_UNSIGNED_INT_24_8:
+        case GL_UNSIGNED_INT_10F_11F_11F_REV:
+        case GL_UNSIGNED_INT_5_9_9_9_REV:
+            return 4;
+        case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+            return 8;
+        default:
+            break;
+    }
+
+    GLsizei component_size;
+    switch(type) {
+        case GL_UNSIGNED_BYTE: case GL_BYTE: component_size = 1; break;
+        case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT: component_size = 2; break;
+        case GL_UNSIGNED_INT: case GL_INT: case GL_FLOAT: component_size = 4; break;
+        default: return 0;
+    }
+    switch(format) {
+        case GL_RED: case GL_GREEN: case GL_BLUE: case GL_ALPHA:
+        case GL_RED_INTEGER: case GL_GREEN_INTEGER: case GL_BLUE_INTEGER:
+        case GL_DEPTH_COMPONENT: case GL_STENCIL_INDEX:
+            return component_size;
+        case GL_RG: case GL_RG_INTEGER:
+            return component_size * 2;
+        case GL_RGB: case GL_BGR: case GL_RGB_INTEGER: case GL_BGR_INTEGER:
+            return component_size * 3;
+        case GL_RGBA: case GL_BGRA: case GL_RGBA_INTEGER: case GL_BGRA_INTEGER:
+            return component_size * 4;
+        default:
+            return 0;
+    }
+}
+
+#pragma region readback_queue
+
+constexpr GLbitfield READBACK_FLAGS = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+double readback_queue::statistics::megabytes_per_second() const {
+    return this->elapsed > 0.0 ? this->bytes / this->elapsed / (1024.0 * 1024.0) : 0.0;
+}
+double readback_queue::statistics::average_latency() const {
+    return this->completed > 0 ? this->total_latency / this->completed : 0.0;
+}
+
+readback_queue::readback_queue(GLsizeiptr max_frame_size, size_t depth)
+    : _max_frame_size(max_frame_size),
+      _next(0),
+      _oldest(0),
+      _pending(0),
+      _sequence(0),
+      _stats{}
+{
+    this->_slots.reserve(depth);
+    for(size_t index = 0; index < depth; index++) {
+        slot& added = this->_slots.emplace_back();
+        added.buffer.storage(max_frame_size, nullptr, READBACK_FLAGS);
+        added.mapping = static_cast<const std::byte*>(added.buffer.map_range(0, max_frame_size, READBACK_FLAGS));
+        added.state = slot_state::free;
+        added.info = {};
+        #ifndef NDEBUG
+        if(added.mapping == nullptr) {
+            std::cerr << "Error: Failed to persistently map readback buffer of size " << max_frame_size << "!" << std::endl;
+        }
+        #endif
+    }
+}
+readback_queue::readback_queue(readback_queue&& move) noexcept
+    : _slots(std::move(move._slots)),
+      _max_frame_size(move._max_frame_size),
+      _next(move._next),
+      _oldest(move._oldest),
+      _pending(move._pending),
+      _sequence(move._sequence),
+      _first_request(move._first_request),
+      _stats(move._stats)
+{
+    move._pending = 0;
+}
+readback_queue::~readback_queue() {
+    //Deleting the pack buffers unmaps them
+}
+
+bool readback_queue::request(framebuffer& fb, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type) {
+    this->_stats.requested++;
+
+    GLint alignment = 4;
+    glGetIntegerv(GL_PACK_ALIGNMENT, &alignment);
+    GLsizei row_pitch = (width * pixel_size(format, type) + alignment - 1) / alignment * alignment;
+    GLsizeiptr size = static_cast<GLsizeiptr>(row_pitch) * height;
+
+    if(this->_slots.empty() || size == 0 || size > this->_max_frame_size) {
+        #ifndef NDEBUG
+        std::cerr << "Error: Readback of " << width << "x" << height << " does not fit readback_queue buffers of size "
+                  << this->_max_frame_size << "!" << std::endl;
+        #endif
+        this->_stats.dropped++;
+        return false;
+    }
+    slot& target = this->_slots[this->_next];
+    if(target.state != slot_state::free || target.mapping == nullptr) {
+        this->_stats.dropped++;
+        return false;
+    }
+
+    fb.bind_read();
+    target.buffer.bind();
+    glReadPixels(x, y, width, height, format, type, nullptr);
+    single_binding_buffer<GL_PIXEL_PACK_BUFFER>::unbind();
+    target.done.emplace();
+
+    target.state = slot_state::pending;
+    target.requested = clock::now();
+    target.info = {std::span<const std::byte>(target.mapping, size), row_pitch, width, height, this->_sequence++, 0.0, this->_next};
+    if(this->_stats.requested - this->_stats.dropped == 1) {
+        this->_first_request = target.requested;
+    }
+    this->_next = (this->_next + 1) % this->_slots.size();
+    this->_pending++;
+    return true;
+}
+
+std::optional<readback_queue::frame> readback_queue::take_oldest(bool wait) {
+    if(this->_pending == 0) {
+        return std::nullopt;
+    }
+    slot& oldest = this->_slots[this->_oldest];
+    if(wait) {
+        oldest.done->client_wait();
+    } else if(!oldest.done->client_wait(0)) {
+        //client_wait flushes, so a poll loop cannot spin on an unsubmitted fence
+        return std::nullopt;
+    }
+    oldest.done.reset();
+    oldest.state = slot_state::acquired;
+
+    clock::time_point now = clock::now();
+    oldest.info.latency = std::chrono::duration<double>(now - oldest.requested).count();
+    this->_stats.completed++;
+    this->_stats.bytes += oldest.info.pixels.size();
+    this->_stats.elapsed = std::chrono::duration<double>(now - this->_first_request).count();
+    this->_stats.total_latency += oldest.info.latency;
+    this->_stats.max_latency = std::max(this->_stats.max_latency, oldest.info.latency);
+
+    this->_oldest = (this->_oldest + 1) % this->_slots.size();
+    this->_pending--;
+    return oldest.info;
+}
+std::optional<readback_queue::frame> readback_queue::poll() {
+    return this->take_oldest(false);
+}
+std::optional<readback_queue::frame> readback_queue::wait() {
+    return this->take_oldest(true);
+}
+void readback_queue::release(frame const& done) {
+    if(done.slot < this->_slots.size() && this->_slots[done.slot].state == slot_state::acquired) {
+        this->_slots[done.slot].state = slot_state::free;
+    }
+}
+
+size_t readback_queue::pending() const {
+    return this->_pending;
+}
+readback_queue::statistics readback_queue::stats() const {
+    return this->_stats;
+}
+
+#pragma endregion
+
+}
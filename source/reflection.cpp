@@ -0,0 +1,261 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#include<bit>
+#include<algorithm>
+
+#include "agl/reflection.hpp"
+
+namespace agl {
+
+size_t glsl_type_size(GLenum type) {
+    switch(type) {
+        case GL_FLOAT: case GL_INT: case GL_UNSIGNED_INT: case GL_BOOL: return 4;
+        case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2: case GL_BOOL_VEC2: return 8;
+        case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3: case GL_BOOL_VEC3: return 12;
+        case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4: case GL_BOOL_VEC4: return 16;
+        case GL_DOUBLE: return 8;
+        case GL_DOUBLE_VEC2: return 16;
+        case GL_DOUBLE_VEC3: return 24;
+        case GL_DOUBLE_VEC4: return 32;
+        case GL_FLOAT_MAT2: return 16;
+        case GL_FLOAT_MAT3: return 36;
+        case GL_FLOAT_MAT4: return 64;
+        case GL_FLOAT_MAT2x3: case GL_FLOAT_MAT3x2: return 24;
+        case GL_FLOAT_MAT2x4: case GL_FLOAT_MAT4x2: return 32;
+        case GL_FLOAT_MAT3x4: case GL_FLOAT_MAT4x3: return 48;
+        case GL_DOUBLE_MAT2: return 32;
+        case GL_DOUBLE_MAT3: return 72;
+        case GL_DOUBLE_MAT4: return 128;
+        case GL_DOUBLE_MAT2x3: case GL_DOUBLE_MAT3x2: return 48;
+        case GL_DOUBLE_MAT2x4: case GL_DOUBLE_MAT4x2: return 64;
+        case GL_DOUBLE_MAT3x4: case GL_DOUBLE_MAT4x3: return 96;
+        default: break;
+    }
+    switch(type) {
+        case GL_SAMPLER_1D: case GL_SAMPLER_2D: case GL_SAMPLER_3D: case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_1D_SHADOW: case GL_SAMPLER_2D_SHADOW: case GL_SAMPLER_1D_ARRAY: case GL_SAMPLER_2D_ARRAY:
+        case GL_SAMPLER_1D_ARRAY_SHADOW: case GL_SAMPLER_2D_ARRAY_SHADOW: case GL_SAMPLER_2D_MULTISAMPLE:
+        case GL_SAMPLER_2D_MULTISAMPLE_ARRAY: case GL_SAMPLER_CUBE_SHADOW: case GL_SAMPLER_BUFFER:
+        case GL_SAMPLER_2D_RECT: case GL_SAMPLER_2D_RECT_SHADOW: case GL_SAMPLER_CUBE_MAP_ARRAY:
+        case GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW:
+        case GL_INT_SAMPLER_1D: case GL_INT_SAMPLER_2D: case GL_INT_SAMPLER_3D: case GL_INT_SAMPLER_CUBE:
+        case GL_INT_SAMPLER_1D_ARRAY: case GL_INT_SAMPLER_2D_ARRAY: case GL_INT_SAMPLER_2D_MULTISAMPLE:
+        case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY: case GL_INT_SAMPLER_BUFFER: case GL_INT_SAMPLER_2D_RECT:
+        case GL_INT_SAMPLER_CUBE_MAP_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_1D: case GL_UNSIGNED_INT_SAMPLER_2D: case GL_UNSIGNED_INT_SAMPLER_3D:
+        case GL_UNSIGNED_INT_SAMPLER_CUBE: case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY: case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE: case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_BUFFER: case GL_UNSIGNED_INT_SAMPLER_2D_RECT:
+        case GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY:
+        case GL_IMAGE_1D: case GL_IMAGE_2D: case GL_IMAGE_3D: case GL_IMAGE_2D_RECT: case GL_IMAGE_CUBE:
+        case GL_IMAGE_BUFFER: case GL_IMAGE_1D_ARRAY: case GL_IMAGE_2D_ARRAY: case GL_IMAGE_CUBE_MAP_ARRAY:
+        case GL_IMAGE_2D_MULTISAMPLE: case GL_IMAGE_2D_MULTISAMPLE_ARRAY:
+        case GL_INT_IMAGE_1D: case GL_INT_IMAGE_2D: case GL_INT_IMAGE_3D: case GL_INT_IMAGE_2D_RECT:
+        case GL_INT_IMAGE_CUBE: case GL_INT_IMAGE_BUFFER: case GL_INT_IMAGE_1D_ARRAY: case GL_INT_IMAGE_2D_ARRAY:
+        case GL_INT_IMAGE_CUBE_MAP_ARRAY: case GL_INT_IMAGE_2D_MULTISAMPLE: case GL_INT_IMAGE_2D_MULTISAMPLE_ARRAY:
+        case GL_UNSIGNED_INT_IMAGE_1D: case GL_UNSIGNED_INT_IMAGE_2D: case GL_UNSIGNED_INT_IMAGE_3D:
+        case GL_UNSIGNED_INT_IMAGE_2D_RECT: case GL_UNSIGNED_INT_IMAGE_CUBE: case GL_UNSIGNED_INT_IMAGE_BUFFER:
+        case GL_UNSIGNED_INT_IMAGE_1D_ARRAY: case GL_UNSIGNED_INT_IMAGE_2D_ARRAY:
+        case GL_UNSIGNED_INT_IMAGE_CUBE_MAP_ARRAY: case GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE:
+        case GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+#pragma region program_reflection
+
+template<typename ENTRY>
+void program_reflection::table::build(std::vector<ENTRY> const& entries) {
+    //At most half full so probes stay short
+    size_t capacity = std::bit_ceil(entries.size() * 2 + 1);
+    this->slots.assign(capacity, 0);
+    for(size_t index = 0; index < entries.size(); index++) {
+        size_t slot = entries[index].hash & (capacity - 1);
+        while(this->slots[slot] != 0) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        this->slots[slot] = static_cast<std::uint32_t>(index + 1);
+    }
+}
+template<typename ENTRY>
+ENTRY const* program_reflection::table::find(std::vector<ENTRY> const& entries, std::uint64_t hash) const {
+    if(this->slots.empty()) {
+        return nullptr;
+    }
+    size_t mask = this->slots.size() - 1;
+    for(size_t slot = hash & mask; this->slots[slot] != 0; slot = (slot + 1) & mask) {
+        ENTRY const& entry = entries[this->slots[slot] - 1];
+        if(entry.hash == hash) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+template<typename ENTRY>
+void program_reflection::add(std::vector<ENTRY>& entries, std::string_view name, ENTRY entry, bool array_alias) {
+    //Arrays ("values[0]") are also registered as "values"
+    entry.hash = hash_name(name);
+    entry.name_offset = this->_names.size();
+    this->_names.append(name);
+    this->_names.push_back('\0');
+    entries.push_back(entry);
+    if(array_alias && name.ends_with("[0]")) {
+        entry.hash = hash_name(name.substr(0, name.size() - 3));
+        entries.push_back(entry);
+    }
+}
+
+void program_reflection::reflect(GLuint program) {
+    this->clear();
+    if(GLAD_GL_VERSION_4_3 || GLAD_GL_ARB_program_interface_query) {
+        this->reflect_resources(program);
+    } else {
+        this->reflect_active(program);
+    }
+    this->_uniform_table.build(this->_uniforms);
+    this->_block_table.build(this->_blocks);
+    this->_attribute_table.build(this->_attributes);
+}
+void program_reflection::reflect_resources(GLuint program) {
+    GLint max_name_length = 0;
+    for(GLenum interface : {GL_UNIFORM, GL_UNIFORM_BLOCK, GL_SHADER_STORAGE_BLOCK, GL_PROGRAM_INPUT}) {
+        GLint length = 0;
+        glGetProgramInterfaceiv(program, interface, GL_MAX_NAME_LENGTH, &length);
+        max_name_length = std::max(max_name_length, length);
+    }
+    std::string name(max_name_length, '\0');
+    auto read_name = [&](GLenum interface, GLuint index) {
+        GLsizei length = 0;
+        glGetProgramResourceName(program, interface, index, max_name_length, &length, name.data());
+        return std::string_view(name.data(), length);
+    };
+
+    GLint count = 0;
+    glGetProgramInterfaceiv(program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &count);
+    for(GLint index = 0; index < count; index++) {
+        const GLenum properties[] = {GL_TYPE, GL_ARRAY_SIZE, GL_LOCATION, GL_BLOCK_INDEX, GL_OFFSET};
+        GLint values[5];
+        glGetProgramResourceiv(program, GL_UNIFORM, index, 5, properties, 5, nullptr, values);
+        this->add(this->_uniforms, read_name(GL_UNIFORM, index),
+                  uniform{0, 0, GLenum(values[0]), values[1], values[2], values[3], values[4]}, true);
+    }
+
+    for(GLenum interface : {GL_UNIFORM_BLOCK, GL_SHADER_STORAGE_BLOCK}) {
+        glGetProgramInterfaceiv(program, interface, GL_ACTIVE_RESOURCES, &count);
+        for(GLint index = 0; index < count; index++) {
+            const GLenum properties[] = {GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE};
+            GLint values[2];
+            glGetProgramResourceiv(program, interface, index, 2, properties, 2, nullptr, values);
+            this->add(this->_blocks, read_name(interface, index),
+                      block{0, 0, interface, GLuint(index), values[0], values[1]}, false);
+        }
+    }
+
+    glGetProgramInterfaceiv(program, GL_PROGRAM_INPUT, GL_ACTIVE_RESOURCES, &count);
+    for(GLint index = 0; index < count; index++) {
+        const GLenum properties[] = {GL_TYPE, GL_ARRAY_SIZE, GL_LOCATION};
+        GLint values[3];
+        glGetProgramResourceiv(program, GL_PROGRAM_INPUT, index, 3, properties, 3, nullptr, values);
+        this->add(this->_attributes, read_name(GL_PROGRAM_INPUT, index),
+                  attribute{0, 0, GLenum(values[0]), values[1], values[2]}, true);
+    }
+}
+void program_reflection::reflect_active(GLuint program) {
+    GLint max_name_length = 0;
+    for(GLenum parameter : {GL_ACTIVE_UNIFORM_MAX_LENGTH, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH,
+                            GL_ACTIVE_ATTRIBUTE_MAX_LENGTH}) {
+        GLint length = 0;
+        glGetProgramiv(program, parameter, &length);
+        max_name_length = std::max(max_name_length, length);
+    }
+    std::string name(max_name_length + 3, '\0');
+    //Arrays may be reported without "[0]", as the program interfaces always report them
+    auto array_name = [&](GLsizei length, GLint array_size) {
+        std::string_view view(name.data(), length);
+        if(array_size > 1 && !view.ends_with(']')) {
+            std::copy_n("[0]", 4, name.data() + length);
+            view = std::string_view(name.data(), length + 3);
+        }
+        return view;
+    };
+
+    GLint count = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    for(GLint index = 0; index < count; index++) {
+        GLsizei length = 0;
+        GLint array_size = 0;
+        GLenum type = GL_NONE;
+        glGetActiveUniform(program, index, max_name_length, &length, &array_size, &type, name.data());
+        GLuint uniform_index = index;
+        GLint block_index = -1;
+        GLint offset = -1;
+        glGetActiveUniformsiv(program, 1, &uniform_index, GL_UNIFORM_BLOCK_INDEX, &block_index);
+        glGetActiveUniformsiv(program, 1, &uniform_index, GL_UNIFORM_OFFSET, &offset);
+        //Block members have no location
+        GLint location = block_index < 0 ? glGetUniformLocation(program, name.data()) : -1;
+        this->add(this->_uniforms, array_name(length, array_size),
+                  uniform{0, 0, type, array_size, location, block_index, offset}, true);
+    }
+
+    //Shader storage blocks can only be queried through the program interfaces
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+    for(GLint index = 0; index < count; index++) {
+        GLsizei length = 0;
+        GLint binding = 0;
+        GLint data_size = 0;
+        glGetActiveUniformBlockName(program, index, max_name_length, &length, name.data());
+        glGetActiveUniformBlockiv(program, index, GL_UNIFORM_BLOCK_BINDING, &binding);
+        glGetActiveUniformBlockiv(program, index, GL_UNIFORM_BLOCK_DATA_SIZE, &data_size);
+        this->add(this->_blocks, std::string_view(name.data(), length),
+                  block{0, 0, GL_UNIFORM_BLOCK, GLuint(index), binding, data_size}, false);
+    }
+
+    glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &count);
+    for(GLint index = 0; index < count; index++) {
+        GLsizei length = 0;
+        GLint array_size = 0;
+        GLenum type = GL_NONE;
+        glGetActiveAttrib(program, index, max_name_length, &length, &array_size, &type, name.data());
+        GLint location = glGetAttribLocation(program, name.data());
+        this->add(this->_attributes, array_name(length, array_size), attribute{0, 0, type, array_size, location}, true);
+    }
+}
+void program_reflection::clear() {
+    this->_uniforms.clear();
+    this->_blocks.clear();
+    this->_attributes.clear();
+    this->_names.clear();
+    this->_uniform_table.slots.clear();
+    this->_block_table.slots.clear();
+    this->_attribute_table.slots.clear();
+}
+
+program_reflection::uniform const* program_reflection::find_uniform(std::uint64_t hash) const {
+    return this->_uniform_table.find(this->_uniforms, hash);
+}
+program_reflection::block const* program_reflection::find_block(std::uint64_t hash) const {
+    return this->_block_table.find(this->_blocks, hash);
+}
+program_reflection::attribute const* program_reflection::find_attribute(std::uint64_t hash) const {
+    return this->_attribute_table.find(this->_attributes, hash);
+}
+
+std::vector<program_reflection::uniform> const& program_reflection::uniforms() const {
+    return this->_uniforms;
+}
+std::vector<program_reflection::block> const& program_reflection::blocks() const {
+    return this->_blocks;
+}
+std::vector<program_reflection::attribute> const& program_reflection::attributes() const {
+    return this->_attributes;
+}
+const char* program_reflection::name(size_t name_offset) const {
+    return this->_names.c_str() + name_offset;
+}
+
+#pragma endregion
+
+}
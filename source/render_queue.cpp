@@ -0,0 +1,158 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#include<algorithm>
+#include<array>
+#include<utility>
+
+#include "agl/render_queue.hpp"
+
+namespace agl {
+
+#pragma region render_queue
+
+constexpr int PASS_BITS = 6;
+constexpr int PROGRAM_BITS = 12;
+constexpr int VERTEX_ARRAY_BITS = 12;
+constexpr int MATERIAL_BITS = 12;
+constexpr int DEPTH_BITS = 22;
+static_assert(PASS_BITS + PROGRAM_BITS + VERTEX_ARRAY_BITS + MATERIAL_BITS + DEPTH_BITS == 64);
+
+constexpr std::uint64_t field(std::uint64_t value, int bits, int shift) {
+    return (value & ((std::uint64_t(1) << bits) - 1)) << shift;
+}
+
+std::uint64_t render_queue::statistics::avoided_state_changes() const {
+    return this->submission_order_state_changes > this->state_changes
+        ? this->submission_order_state_changes - this->state_changes : 0;
+}
+
+std::uint64_t render_queue::make_key(std::uint32_t pass, GLuint program, GLuint vertex_array, std::uint32_t material, float depth) {
+    depth = std::clamp(depth, 0.0f, 1.0f);
+    auto quantized = static_cast<std::uint64_t>(depth * float((1 << DEPTH_BITS) - 1));
+    return field(pass, PASS_BITS, 64 - PASS_BITS)
+         | field(program, PROGRAM_BITS, MATERIAL_BITS + VERTEX_ARRAY_BITS + DEPTH_BITS)
+         | field(vertex_array, VERTEX_ARRAY_BITS, MATERIAL_BITS + DEPTH_BITS)
+         | field(material, MATERIAL_BITS, DEPTH_BITS)
+         | field(quantized, DEPTH_BITS, 0);
+}
+
+render_queue::render_queue(size_t arena_block_size)
+    : _arena(arena_block_size),
+      _stats{}
+{}
+
+void render_queue::submit(std::uint32_t pass, std::uint32_t material, float depth, render_command const& command) {
+    this->submit(make_key(pass, command.prog->id(), command.vao->id(), material, depth), command);
+}
+void render_queue::submit(std::uint64_t key, render_command const& command) {
+    render_command* recorded = this->_arena.make<render_command>(command);
+    recorded->textures = this->_arena.copy(command.textures);
+    this->_entries.push_back({key, recorded});
+}
+
+std::uint64_t render_queue::count_state_changes(std::span<const entry> entries) {
+    std::uint64_t changes = 0;
+    render_command const* previous = nullptr;
+    for(entry const& current : entries) {
+        render_command const& command = *current.command;
+        if(previous == nullptr || previous->prog != command.prog) {
+            changes++;
+        }
+        if(previous == nullptr || previous->vao != command.vao) {
+            changes++;
+        }
+        for(size_t unit = 0; unit < command.textures.size(); unit++) {
+            if(previous == nullptr || unit >= previous->textures.size() || previous->textures[unit] != command.textures[unit]) {
+                changes++;
+            }
+        }
+        previous = &command;
+    }
+    return changes;
+}
+
+void render_queue::radix_sort() {
+    //LSD radix sort on 8 bit digits, digits every key shares are skipped
+    size_t count = this->_entries.size();
+    std::array<std::array<size_t, 256>, 8> histograms{};
+    for(entry const& current : this->_entries) {
+        for(int digit = 0; digit < 8; digit++) {
+            histograms[digit][(current.key >> (digit * 8)) & 0xFF]++;
+        }
+    }
+
+    this->_scratch.resize(count);
+    for(int digit = 0; digit < 8; digit++) {
+        std::array<size_t, 256>& histogram = histograms[digit];
+        if(histogram[(this->_entries[0].key >> (digit * 8)) & 0xFF] == count) {
+            continue;
+        }
+        size_t offset = 0;
+        for(size_t& bucket : histogram) {
+            size_t bucket_count = bucket;
+            bucket = offset;
+            offset += bucket_count;
+        }
+        for(entry const& current : this->_entries) {
+            this->_scratch[histogram[(current.key >> (digit * 8)) & 0xFF]++] = current;
+        }
+        this->_entries.swap(this->_scratch);
+    }
+}
+
+void render_queue::replay(render_command const& command) {
+    //Binds are cached, only the ones that change reach GL
+    command.prog->bind();
+    command.vao->bind();
+    for(size_t unit = 0; unit < command.textures.size(); unit++) {
+        if(command.textures[unit] != nullptr) {
+            command.textures[unit]->bind(static_cast<GLuint>(unit));
+        }
+    }
+    if(command.setup != nullptr) {
+        command.setup(command.user);
+    }
+
+    if(command.index_type == 0) {
+        glDrawArraysInstancedBaseInstance(command.mode, command.first, command.count,
+            command.instance_count, command.base_instance);
+        return;
+    }
+    size_t index_size = command.index_type == GL_UNSIGNED_BYTE ? 1 : command.index_type == GL_UNSIGNED_SHORT ? 2 : 4;
+    glDrawElementsInstancedBaseVertexBaseInstance(command.mode, command.count, command.index_type,
+        reinterpret_cast<const void*>(command.first * index_size),
+        command.instance_count, command.base_vertex, command.base_instance);
+}
+
+void render_queue::flush() {
+    if(this->_entries.empty()) {
+        return;
+    }
+    this->_stats.commands += this->_entries.size();
+    this->_stats.submission_order_state_changes += count_state_changes(this->_entries);
+    this->radix_sort();
+    this->_stats.state_changes += count_state_changes(this->_entries);
+
+    for(entry const& current : this->_entries) {
+        replay(*current.command);
+    }
+    this->clear();
+}
+void render_queue::clear() {
+    this->_entries.clear();
+    this->_arena.reset();
+}
+size_t render_queue::size() const {
+    return this->_entries.size();
+}
+
+render_queue::statistics render_queue::stats() const {
+    return this->_stats;
+}
+void render_queue::reset_stats() {
+    this->_stats = {};
+}
+
+#pragma endregion
+
+}
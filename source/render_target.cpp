@@ -0,0 +1,217 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#include<iostream>
+#include<algorithm>
+#include<utility>
+
+#include "agl/render_target.hpp"
+
+namespace agl {
+
+#pragma region render_target
+
+void render_target::bind() {
+    this->_framebuffer.bind();
+}
+void render_target::invalidate() {
+    if(!this->_discardable.empty()) {
+        this->_framebuffer.invalidate(this->_discardable);
+    }
+}
+void render_target::invalidate_all() {
+    if(!this->_all.empty()) {
+        this->_framebuffer.invalidate(this->_all);
+    }
+}
+bool render_target::complete() const {
+    return this->_status == GL_FRAMEBUFFER_COMPLETE;
+}
+GLenum render_target::status() const {
+    return this->_status;
+}
+any_texture* render_target::texture(GLenum attachment) const {
+    for(attachment_info const& info : this->_attachments) {
+        if(info.attachment == attachment) {
+            return info.texture;
+        }
+    }
+    return nullptr;
+}
+framebuffer& render_target::get_framebuffer() {
+    return this->_framebuffer;
+}
+
+#pragma endregion
+
+#pragma region framebuffer_builder
+
+framebuffer_builder& framebuffer_builder::attach(GLenum attachment, any_texture& texture, GLint level, bool discardable) {
+    this->_target._framebuffer.attach(attachment, texture, level);
+    this->add(attachment, &texture, discardable);
+    return *this;
+}
+framebuffer_builder& framebuffer_builder::attach(GLenum attachment, renderbuffer& buffer, bool discardable) {
+    this->_target._framebuffer.attach(attachment, buffer);
+    this->add(attachment, nullptr, discardable);
+    return *this;
+}
+framebuffer_builder& framebuffer_builder::color(GLuint index, any_texture& texture, GLint level, bool discardable) {
+    return this->attach(GL_COLOR_ATTACHMENT0 + index, texture, level, discardable);
+}
+framebuffer_builder& framebuffer_builder::color(GLuint index, renderbuffer& buffer, bool discardable) {
+    return this->attach(GL_COLOR_ATTACHMENT0 + index, buffer, discardable);
+}
+
+void framebuffer_builder::add(GLenum attachment, any_texture* texture, bool discardable) {
+    std::erase_if(this->_target._attachments, [&](auto const& info) {return info.attachment == attachment;});
+    std::erase(this->_target._all, attachment);
+    std::erase(this->_target._discardable, attachment);
+
+    this->_target._attachments.push_back({attachment, texture});
+    this->_target._all.push_back(attachment);
+    if(discardable) {
+        this->_target._discardable.push_back(attachment);
+    }
+}
+
+render_target framebuffer_builder::build() {
+    std::vector<GLenum> draw_buffers;
+    for(GLenum attachment : this->_target._all) {
+        if(attachment >= GL_COLOR_ATTACHMENT0 && attachment <= GL_COLOR_ATTACHMENT31) {
+            draw_buffers.push_back(attachment);
+        }
+    }
+    std::sort(draw_buffers.begin(), draw_buffers.end());
+    //Draw buffer i writes fragment output i, gaps between color attachments stay GL_NONE
+    std::vector<GLenum> outputs;
+    for(GLenum attachment : draw_buffers) {
+        outputs.resize(attachment - GL_COLOR_ATTACHMENT0, GL_NONE);
+        outputs.push_back(attachment);
+    }
+    this->_target._framebuffer.draw_buffers(outputs);
+    if(outputs.empty()) {
+        this->_target._framebuffer.read_buffer(GL_NONE);
+    }
+
+    this->_target._status = this->_target._framebuffer.status();
+    #ifndef NDEBUG
+    if(this->_target._status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Error: Framebuffer incomplete, status 0x" << std::hex << this->_target._status << std::dec << "!" << std::endl;
+    }
+    #endif
+    return std::move(this->_target);
+}
+
+#pragma endregion
+
+#pragma region render_target_pool
+
+any_texture& render_target_pool::pooled_texture::get() {
+    return std::visit([](auto& texture) -> any_texture& {return texture;}, this->texture);
+}
+
+render_target_pool::render_target_pool(std::uint32_t max_idle_frames)
+    : _max_idle_frames(max_idle_frames),
+      _frame(0),
+      _stats{}
+{}
+
+render_target_pool::pooled_texture& render_target_pool::acquire_texture(GLenum internal_format, GLsizei width, GLsizei height, GLsizei samples) {
+    for(auto& pooled : this->_textures) {
+        if(!pooled->in_use && pooled->internal_format == internal_format
+            && pooled->width == width && pooled->height == height && pooled->samples == samples) {
+            pooled->in_use = true;
+            pooled->last_used = this->_frame;
+            this->_stats.texture_reuses++;
+            return *pooled;
+        }
+    }
+
+    auto added = std::make_unique<pooled_texture>(pooled_texture{
+        internal_format, width, height, samples,
+        samples > 0
+            ? std::variant<texture_2d, multisample_texture_2d>(std::in_place_type<multisample_texture_2d>)
+            : std::variant<texture_2d, multisample_texture_2d>(std::in_place_type<texture_2d>),
+        true, this->_frame
+    });
+    if(samples > 0) {
+        std::get<multisample_texture_2d>(added->texture).storage_multisample(samples, internal_format, width, height);
+    } else {
+        std::get<texture_2d>(added->texture).storage(1, internal_format, width, height);
+    }
+    this->_stats.texture_allocations++;
+    this->_textures.push_back(std::move(added));
+    return *this->_textures.back();
+}
+
+render_target& render_target_pool::acquire(GLsizei width, GLsizei height, GLsizei samples, std::span<const transient_attachment> attachments) {
+    std::vector<std::pair<GLenum, pooled_texture*>> key;
+    key.reserve(attachments.size());
+    for(transient_attachment const& attachment : attachments) {
+        key.emplace_back(attachment.attachment, &this->acquire_texture(attachment.internal_format, width, height, samples));
+    }
+
+    cached_target* found = nullptr;
+    for(auto& cached : this->_targets) {
+        if(cached->key == key) {
+            found = cached.get();
+            this->_stats.target_reuses++;
+            break;
+        }
+    }
+    if(found == nullptr) {
+        framebuffer_builder builder;
+        for(size_t index = 0; index < attachments.size(); index++) {
+            builder.attach(attachments[index].attachment, key[index].second->get(), 0, attachments[index].discardable);
+        }
+        this->_targets.push_back(std::make_unique<cached_target>(cached_target{key, builder.build(), this->_frame}));
+        this->_stats.target_builds++;
+        found = this->_targets.back().get();
+    }
+
+    found->last_used = this->_frame;
+    found->target.invalidate_all();
+    return found->target;
+}
+
+void render_target_pool::release(render_target& target) {
+    for(auto& cached : this->_targets) {
+        if(&cached->target == &target) {
+            for(auto& [attachment, pooled] : cached->key) {
+                pooled->in_use = false;
+            }
+            return;
+        }
+    }
+}
+
+void render_target_pool::end_frame() {
+    for(auto& pooled : this->_textures) {
+        pooled->in_use = false;
+    }
+    this->_frame++;
+
+    auto idle = [this](std::uint64_t last_used) {
+        return last_used + this->_max_idle_frames < this->_frame;
+    };
+    //Targets go first, they point at the textures
+    std::erase_if(this->_targets, [&](auto const& cached) {
+        if(idle(cached->last_used)) {
+            return true;
+        }
+        return std::any_of(cached->key.begin(), cached->key.end(),
+            [&](auto const& entry) {return idle(entry.second->last_used);});
+    });
+    std::erase_if(this->_textures, [&](auto const& pooled) {return idle(pooled->last_used);});
+}
+
+render_target_pool::statistics render_target_pool::stats() const {
+    statistics result = this->_stats;
+    result.textures = this->_textures.size();
+    result.targets = this->_targets.size();
+    return result;
+}
+
+#pragma endregion
+
+}
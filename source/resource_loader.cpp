@@ -0,0 +1,154 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#include<iostream>
+#include<future>
+#include<algorithm>
+#include<iterator>
+
+#include "agl/resource_loader.hpp"
+
+namespace agl {
+
+#pragma region resource_loader
+
+resource_loader::resource_loader(size_t worker_count)
+    : _stopping(false),
+      _pending(0)
+{
+    context_factory const* factory = get_context_factory();
+    if(factory != nullptr) {
+        this->_factory = *factory;
+    }
+    this->start(worker_count);
+}
+resource_loader::resource_loader(size_t worker_count, context_factory const& factory)
+    : _factory(factory),
+      _stopping(false),
+      _pending(0)
+{
+    this->start(worker_count);
+}
+resource_loader::~resource_loader() {
+    {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        this->_stopping = true;
+    }
+    this->_wake.notify_all();
+    for(std::thread& worker : this->_workers) {
+        worker.join();
+    }
+    for(void* context : this->_contexts) {
+        this->_factory->destroy(context, this->_factory->user);
+    }
+}
+
+void resource_loader::start(size_t worker_count) {
+    if(!this->_factory) {
+        #ifndef NDEBUG
+        std::cerr << "Warning: No context_factory registered, resource_loader jobs run on the render thread!" << std::endl;
+        #endif
+        return;
+    }
+    context_factory const& factory = *this->_factory;
+    for(size_t index = 0; index < worker_count; index++) {
+        void* context = factory.create(factory.user);
+        if(context == nullptr) {
+            #ifndef NDEBUG
+            std::cerr << "Error: context_factory failed to create a shared context!" << std::endl;
+            #endif
+            continue;
+        }
+
+        //The worker reports whether its context became current before the next one is created
+        std::promise<bool> started;
+        std::future<bool> result = started.get_future();
+        std::thread worker([this, context, &started]() {
+            bool current = this->_factory->make_current(context, this->_factory->user);
+            started.set_value(current);
+            if(current) {
+                this->worker_main();
+                this->_factory->make_current(nullptr, this->_factory->user);
+            }
+        });
+        if(result.get()) {
+            this->_workers.push_back(std::move(worker));
+            this->_contexts.push_back(context);
+        } else {
+            #ifndef NDEBUG
+            std::cerr << "Error: Failed to make a shared context current on a resource_loader worker!" << std::endl;
+            #endif
+            worker.join();
+            factory.destroy(context, factory.user);
+        }
+    }
+}
+
+void resource_loader::enqueue(std::shared_ptr<loader_job> job) {
+    this->_pending++;
+    if(this->_workers.empty()) {
+        job->run();
+        job->completion.emplace();
+        this->_unpublished.push_back(std::move(job));
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        this->_queue.push_back(std::move(job));
+    }
+    this->_wake.notify_one();
+}
+
+void resource_loader::worker_main() {
+    while(true) {
+        std::shared_ptr<loader_job> job;
+        {
+            std::unique_lock<std::mutex> lock(this->_mutex);
+            this->_wake.wait(lock, [this]() {return this->_stopping || !this->_queue.empty();});
+            if(this->_queue.empty()) {
+                return;
+            }
+            job = std::move(this->_queue.front());
+            this->_queue.pop_front();
+        }
+
+        job->run();
+        //Other contexts can only wait on a fence that was flushed
+        job->completion.emplace();
+        glFlush();
+        //The render thread may delete what this job bound
+        forget_thread_bindings();
+
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        this->_completed.push_back(std::move(job));
+    }
+}
+
+size_t resource_loader::publish() {
+    {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        std::move(this->_completed.begin(), this->_completed.end(), std::back_inserter(this->_unpublished));
+        this->_completed.clear();
+    }
+    auto end = std::remove_if(this->_unpublished.begin(), this->_unpublished.end(),
+        [](std::shared_ptr<loader_job> const& job) {
+            if(!job->completion->signaled()) {
+                return false;
+            }
+            job->published = true;
+            return true;
+        });
+    size_t published = std::distance(end, this->_unpublished.end());
+    this->_unpublished.erase(end, this->_unpublished.end());
+    this->_pending -= published;
+    return published;
+}
+size_t resource_loader::pending() const {
+    return this->_pending;
+}
+size_t resource_loader::worker_count() const {
+    return this->_workers.size();
+}
+
+#pragma endregion
+
+}
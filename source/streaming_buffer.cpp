@@ -0,0 +1,102 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#include<iostream>
+#include<utility>
+#include<algorithm>
+
+#include "agl/streaming_buffer.hpp"
+
+namespace agl {
+
+#pragma region streaming_buffer
+
+//Largest alignment any offset (UBO/SSBO/vertex) is expected to need,
+//keeps every region's base offset aligned
+constexpr GLsizeiptr REGION_ALIGNMENT = 256;
+constexpr GLbitfield STREAMING_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+streaming_buffer::streaming_buffer(GLsizeiptr frame_size, GLuint frame_count)
+    : _mapping(nullptr),
+      _frame_size((frame_size + REGION_ALIGNMENT - 1) / REGION_ALIGNMENT * REGION_ALIGNMENT),
+      _frame_count(std::max(frame_count, 1u)),
+      _frame(0),
+      _head(0),
+      _fences(this->_frame_count)
+{
+    GLsizeiptr total_size = this->_frame_size * this->_frame_count;
+    this->_buffer.storage(total_size, nullptr, STREAMING_FLAGS);
+    this->_mapping = static_cast<std::byte*>(this->_buffer.map_range(0, total_size, STREAMING_FLAGS));
+    #ifndef NDEBUG
+    if(this->_mapping == nullptr) {
+        std::cerr << "Error: Failed to persistently map streaming_buffer of size " << total_size << "!" << std::endl;
+    }
+    #endif
+}
+streaming_buffer::streaming_buffer(streaming_buffer&& move) noexcept
+    : _buffer(std::move(move._buffer)),
+      _mapping(move._mapping),
+      _frame_size(move._frame_size),
+      _frame_count(move._frame_count),
+      _frame(move._frame),
+      _head(move._head),
+      _fences(std::move(move._fences))
+{
+    move._mapping = nullptr;
+    move._frame_count = 0;
+    move._frame = 0;
+    move._head = move._frame_size;
+}
+streaming_buffer::~streaming_buffer() {
+    //Deleting the buffer implicitly unmaps it
+}
+
+streaming_buffer::allocation streaming_buffer::allocate(GLsizeiptr size, GLsizeiptr alignment) {
+    GLintptr region_begin = this->_frame * this->_frame_size;
+    GLintptr offset = region_begin + this->_head;
+    offset = (offset + alignment - 1) / alignment * alignment;
+    if(this->_mapping == nullptr || offset + size > region_begin + this->_frame_size) {
+        return {nullptr, 0, 0};
+    }
+    this->_head = offset + size - region_begin;
+    return {this->_mapping + offset, offset, size};
+}
+
+void streaming_buffer::next_frame() {
+    //Moved from, or the mapping failed
+    if(this->_mapping == nullptr) {
+        return;
+    }
+    this->_fences[this->_frame].emplace();
+    this->_frame = (this->_frame + 1) % this->_frame_count;
+    this->_head = 0;
+
+    std::optional<fence>& pending = this->_fences[this->_frame];
+    if(pending) {
+        pending->client_wait();
+        pending.reset();
+    }
+}
+
+void streaming_buffer::bind(GLenum target) {
+    this->_buffer.bind(target);
+}
+void streaming_buffer::bind_range(GLenum target, GLuint index, allocation const& alloc) {
+    this->_buffer.bind_range(target, index, alloc.offset, alloc.size);
+}
+GLuint streaming_buffer::id() {
+    return this->_buffer.id();
+}
+
+GLsizeiptr streaming_buffer::frame_size() const {
+    return this->_frame_size;
+}
+GLuint streaming_buffer::frame_count() const {
+    return this->_frame_count;
+}
+GLuint streaming_buffer::frame_index() const {
+    return this->_frame;
+}
+
+#pragma endregion
+
+}
@@ -0,0 +1,186 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#include<iostream>
+#include<algorithm>
+
+#include "agl/texture_table.hpp"
+#include "agl/context_util.hpp"
+
+namespace agl {
+
+#pragma region texture_table
+
+texture_table::texture_table(GLuint capacity, GLuint max_resident,
+                             GLenum fallback_format, GLsizei width, GLsizei height, GLsizei levels)
+    : _bindless(bindless_texture()),
+      _capacity(capacity),
+      _max_resident(std::max(max_resident, 1u)),
+      _width(width),
+      _height(height),
+      _levels(levels),
+      _size(0),
+      _resident(0),
+      _frame(0),
+      _dirty_begin(capacity),
+      _dirty_end(0),
+      _stats{}
+{
+    this->_entries.reserve(capacity);
+    if(this->_bindless) {
+        this->_handles.resize(capacity, 0);
+        this->_handle_buffer.emplace();
+        this->_handle_buffer->storage(capacity * sizeof(GLuint64), this->_handles.data(), GL_DYNAMIC_STORAGE_BIT);
+    } else {
+        this->_array.emplace();
+        this->_array->storage(levels, fallback_format, width, height, capacity);
+        this->_array->parameter(GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    }
+}
+texture_table::~texture_table() {
+    for(GLuint index : this->_lru) {
+        glMakeTextureHandleNonResidentARB(this->_entries[index].handle);
+    }
+}
+
+bool texture_table::bindless() const {
+    return this->_bindless;
+}
+std::string_view texture_table::defines() const {
+    return this->_bindless ? "#define AGL_TEXTURE_TABLE_BINDLESS\n" : "";
+}
+
+GLuint texture_table::add(texture_2d& texture, sampler* with) {
+    GLuint64 handle = 0;
+    if(this->_bindless) {
+        //The same texture (and sampler) always gives the same handle, which is made resident once
+        handle = with ? glGetTextureSamplerHandleARB(texture.id(), with->id()) : glGetTextureHandleARB(texture.id());
+        auto existing = this->_indices.find(handle);
+        if(existing != this->_indices.end()) {
+            this->_entries[existing->second].references++;
+            return existing->second;
+        }
+    }
+    GLuint index;
+    if(!this->_free.empty()) {
+        index = this->_free.back();
+        this->_free.pop_back();
+    } else if(this->_entries.size() < this->_capacity) {
+        index = static_cast<GLuint>(this->_entries.size());
+        this->_entries.emplace_back();
+    } else {
+        #ifndef NDEBUG
+        std::cerr << "Error: texture_table of capacity " << this->_capacity << " is full!" << std::endl;
+        #endif
+        return NO_INDEX;
+    }
+    entry& added = this->_entries[index];
+    added = {handle, 0, 1, false, this->_lru.end()};
+    if(this->_bindless) {
+        this->_indices.emplace(handle, index);
+        this->_handles[index] = handle;
+        this->_dirty_begin = std::min<size_t>(this->_dirty_begin, index);
+        this->_dirty_end = std::max<size_t>(this->_dirty_end, index + 1);
+    } else {
+        //Layers keep no sampler, the array's parameters apply
+        for(GLsizei level = 0; level < this->_levels; level++) {
+            glCopyImageSubData(texture.id(), GL_TEXTURE_2D, level, 0, 0, 0,
+                               this->_array->id(), GL_TEXTURE_2D_ARRAY, level, 0, 0, index,
+                               std::max(this->_width >> level, 1), std::max(this->_height >> level, 1), 1);
+        }
+    }
+    this->_size++;
+    return index;
+}
+void texture_table::remove(GLuint index) {
+    entry& removed = this->_entries[index];
+    if(--removed.references > 0) {
+        return;
+    }
+    if(this->_bindless) {
+        if(removed.resident) {
+            this->make_non_resident(index);
+        }
+        this->_indices.erase(removed.handle);
+        this->_handles[index] = 0;
+        this->_dirty_begin = std::min<size_t>(this->_dirty_begin, index);
+        this->_dirty_end = std::max<size_t>(this->_dirty_end, index + 1);
+    }
+    this->_free.push_back(index);
+    this->_size--;
+}
+
+void texture_table::use(GLuint index) {
+    entry& used = this->_entries[index];
+    used.last_used = this->_frame;
+    if(!this->_bindless) {
+        return;
+    }
+    if(used.resident) {
+        this->_lru.splice(this->_lru.begin(), this->_lru, used.lru);
+        return;
+    }
+    this->make_resident(index);
+    //Evict the least recently used, never what this frame's draws may still read
+    while(this->_resident > this->_max_resident) {
+        GLuint oldest = this->_lru.back();
+        if(this->_entries[oldest].last_used == this->_frame) {
+            this->_stats.over_budget++;
+            break;
+        }
+        this->make_non_resident(oldest);
+        this->_stats.evictions++;
+    }
+}
+
+void texture_table::make_resident(GLuint index) {
+    entry& made = this->_entries[index];
+    glMakeTextureHandleResidentARB(made.handle);
+    made.resident = true;
+    made.lru = this->_lru.insert(this->_lru.begin(), index);
+    this->_resident++;
+    this->_stats.made_resident++;
+}
+void texture_table::make_non_resident(GLuint index) {
+    entry& made = this->_entries[index];
+    glMakeTextureHandleNonResidentARB(made.handle);
+    made.resident = false;
+    this->_lru.erase(made.lru);
+    made.lru = this->_lru.end();
+    this->_resident--;
+    this->_stats.made_non_resident++;
+}
+
+void texture_table::bind(GLuint storage_index, GLuint unit) {
+    if(!this->_bindless) {
+        this->_array->bind(unit);
+        return;
+    }
+    if(this->_dirty_begin < this->_dirty_end) {
+        this->_handle_buffer->sub_data(this->_dirty_begin * sizeof(GLuint64),
+                                       (this->_dirty_end - this->_dirty_begin) * sizeof(GLuint64),
+                                       this->_handles.data() + this->_dirty_begin);
+        this->_dirty_begin = this->_capacity;
+        this->_dirty_end = 0;
+    }
+    this->_handle_buffer->bind_range(GL_SHADER_STORAGE_BUFFER, storage_index, 0, this->_capacity * sizeof(GLuint64));
+}
+void texture_table::end_frame() {
+    this->_frame++;
+}
+
+array_texture_2d* texture_table::fallback_array() {
+    return this->_array ? &*this->_array : nullptr;
+}
+
+GLuint texture_table::size() const {
+    return this->_size;
+}
+texture_table::statistics texture_table::stats() const {
+    statistics current = this->_stats;
+    current.resident = this->_resident;
+    return current;
+}
+
+#pragma endregion
+
+}
@@ -0,0 +1,147 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#include<iostream>
+#include<algorithm>
+#include<utility>
+#include<cstring>
+
+#include "agl/texture_upload.hpp"
+
+namespace agl {
+
+#pragma region texture_upload_pool
+
+constexpr GLbitfield STAGING_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+//Keeps every upload's offset valid for any pixel format's alignment
+constexpr GLsizeiptr STAGING_ALIGNMENT = 16;
+
+double texture_upload_pool::statistics::throughput() const {
+    return this->cpu_seconds > 0.0 ? this->bytes / this->cpu_seconds : 0.0;
+}
+double texture_upload_pool::statistics::average_latency() const {
+    return this->completed_batches > 0 ? this->total_latency / this->completed_batches : 0.0;
+}
+
+texture_upload_pool::texture_upload_pool(GLsizeiptr staging_size, size_t staging_count)
+    : _staging_size(staging_size),
+      _current(0),
+      _head(0),
+      _stats{}
+{
+    this->_staging.reserve(staging_count);
+    for(size_t index = 0; index < staging_count; index++) {
+        staging& added = this->_staging.emplace_back();
+        added.buffer.storage(staging_size, nullptr, STAGING_FLAGS);
+        added.mapping = static_cast<std::byte*>(added.buffer.map_range(0, staging_size, STAGING_FLAGS));
+        #ifndef NDEBUG
+        if(added.mapping == nullptr) {
+            std::cerr << "Error: Failed to persistently map texture upload staging buffer of size " << staging_size << "!" << std::endl;
+        }
+        #endif
+    }
+}
+texture_upload_pool::texture_upload_pool(texture_upload_pool&& move) noexcept
+    : _staging(std::move(move._staging)),
+      _staging_size(move._staging_size),
+      _current(move._current),
+      _head(move._head),
+      _upload_start(move._upload_start),
+      _stats(move._stats)
+{
+    //The moved-from pool then uploads directly and flushes nothing instead of indexing its empty staging list
+    move._staging.clear();
+    move._staging_size = 0;
+    move._current = 0;
+    move._head = 0;
+}
+texture_upload_pool::~texture_upload_pool() {
+    //Deleting the staging buffers unmaps them, the GL keeps them alive until pending uploads finish
+}
+
+const void* texture_upload_pool::stage(std::span<const std::byte> pixels) {
+    this->_upload_start = clock::now();
+    GLsizeiptr size = static_cast<GLsizeiptr>(pixels.size());
+    if(this->_staging.empty() || size > this->_staging_size || this->_staging[this->_current].mapping == nullptr) {
+        this->_stats.direct_uploads++;
+        single_binding_buffer<GL_PIXEL_UNPACK_BUFFER>::unbind();
+        return pixels.data();
+    }
+
+    GLsizeiptr offset = (this->_head + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+    if(offset + size > this->_staging_size) {
+        this->retire_current();
+        offset = 0;
+    }
+    staging& current = this->_staging[this->_current];
+    if(current.retired) {
+        this->reclaim(current, true);
+    }
+    if(this->_head == 0) {
+        current.first_upload = this->_upload_start;
+    }
+
+    std::memcpy(current.mapping + offset, pixels.data(), size);
+    this->_head = offset + size;
+    current.buffer.bind();
+    return reinterpret_cast<const void*>(offset);
+}
+void texture_upload_pool::end_upload(size_t bytes) {
+    //Later pixel transfers with client pointers must not read from the staging buffer
+    single_binding_buffer<GL_PIXEL_UNPACK_BUFFER>::unbind();
+    this->_stats.uploads++;
+    this->_stats.bytes += bytes;
+    this->_stats.cpu_seconds += std::chrono::duration<double>(clock::now() - this->_upload_start).count();
+}
+
+void texture_upload_pool::retire_current() {
+    this->_staging[this->_current].retired.emplace();
+    this->_current = (this->_current + 1) % this->_staging.size();
+    this->_head = 0;
+}
+bool texture_upload_pool::reclaim(staging& stage, bool wait) {
+    if(!stage.retired) {
+        return true;
+    }
+    if(wait) {
+        auto stall_start = clock::now();
+        stage.retired->client_wait();
+        this->_stats.stall_seconds += std::chrono::duration<double>(clock::now() - stall_start).count();
+    } else if(!stage.retired->signaled()) {
+        return false;
+    }
+    stage.retired.reset();
+
+    double latency = std::chrono::duration<double>(clock::now() - stage.first_upload).count();
+    this->_stats.completed_batches++;
+    this->_stats.last_latency = latency;
+    this->_stats.max_latency = std::max(this->_stats.max_latency, latency);
+    this->_stats.total_latency += latency;
+    return true;
+}
+
+void texture_upload_pool::flush() {
+    if(this->_head > 0) {
+        this->retire_current();
+    }
+    //Oldest first so last_latency ends on the newest batch
+    for(size_t age = 1; age <= this->_staging.size(); age++) {
+        this->reclaim(this->_staging[(this->_current + age) % this->_staging.size()], false);
+    }
+}
+
+texture_upload_pool::statistics texture_upload_pool::stats() const {
+    return this->_stats;
+}
+void texture_upload_pool::reset_stats() {
+    this->_stats = {};
+}
+GLsizeiptr texture_upload_pool::staging_size() const {
+    return this->_staging_size;
+}
+size_t texture_upload_pool::staging_count() const {
+    return this->_staging.size();
+}
+
+#pragma endregion
+
+}
@@ -0,0 +1,81 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#include<iostream>
+#include<string>
+
+#include "agl/uniform_block.hpp"
+
+namespace agl {
+
+#pragma region interface_block
+
+//Returns -1 if the member is not active in the program
+static GLint reflected_member_offset(GLuint program, GLenum interface, const char* block_name, const char* member_name) {
+    //Members of blocks are reflected as "Block.member" when the block has an instance name, arrays as "member[0]"
+    const std::string candidates[] = {
+        member_name,
+        std::string(member_name) + "[0]",
+        std::string(block_name) + "." + member_name,
+        std::string(block_name) + "." + member_name + "[0]"
+    };
+    for(std::string const& candidate : candidates) {
+        GLuint index = glGetProgramResourceIndex(program, interface, candidate.c_str());
+        if(index != GL_INVALID_INDEX) {
+            const GLenum property = GL_OFFSET;
+            GLint offset = -1;
+            glGetProgramResourceiv(program, interface, index, 1, &property, 1, nullptr, &offset);
+            return offset;
+        }
+    }
+    return -1;
+}
+
+bool validate_block_layout(
+    program& prog,
+    GLenum target,
+    const char* block_name,
+    size_t size,
+    std::span<const char* const> member_names,
+    std::span<const size_t> member_offsets
+) {
+    GLenum block_interface = target == GL_UNIFORM_BUFFER ? GL_UNIFORM_BLOCK : GL_SHADER_STORAGE_BLOCK;
+    GLenum member_interface = target == GL_UNIFORM_BUFFER ? GL_UNIFORM : GL_BUFFER_VARIABLE;
+
+    GLuint block_index = glGetProgramResourceIndex(prog.id(), block_interface, block_name);
+    if(block_index == GL_INVALID_INDEX) {
+        #ifndef NDEBUG
+        std::cerr << "Error Block: \"" << block_name << "\" Not Found!" << std::endl;
+        #endif
+        return false;
+    }
+
+    bool valid = true;
+    const GLenum property = GL_BUFFER_DATA_SIZE;
+    GLint reflected_size = 0;
+    glGetProgramResourceiv(prog.id(), block_interface, block_index, 1, &property, 1, nullptr, &reflected_size);
+    //Runtime sized SSBO arrays reflect a smaller size than the buffer may hold, a larger one means members are missing
+    if(size_t(reflected_size) > size) {
+        valid = false;
+        #ifndef NDEBUG
+        std::cerr << "Error Block: \"" << block_name << "\" is " << reflected_size
+                  << " bytes in the program but " << size << " bytes on the CPU!" << std::endl;
+        #endif
+    }
+
+    for(size_t index = 0; index < member_names.size(); index++) {
+        GLint offset = reflected_member_offset(prog.id(), member_interface, block_name, member_names[index]);
+        //Inactive members are optimized out and can't be checked
+        if(offset >= 0 && size_t(offset) != member_offsets[index]) {
+            valid = false;
+            #ifndef NDEBUG
+            std::cerr << "Error Block: \"" << block_name << "." << member_names[index] << "\" is at offset " << offset
+                      << " in the program but " << member_offsets[index] << " on the CPU!" << std::endl;
+            #endif
+        }
+    }
+    return valid;
+}
+
+#pragma endregion
+
+}
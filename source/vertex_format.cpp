@@ -0,0 +1,105 @@
+//Copyright (C) - Kevin Hayes - 2022 - All Rights Reserved
+
+#include<algorithm>
+#include<utility>
+
+#include "agl/vertex_format.hpp"
+
+namespace agl {
+
+#pragma region vertex_format
+
+vertex_format::vertex_format(std::vector<attribute> attributes, std::vector<stream> streams)
+    : _attributes(std::move(attributes)),
+      _streams(std::move(streams))
+{}
+
+void vertex_format::apply(vertex_array& vao) const {
+    for(attribute const& attrib : this->_attributes) {
+        vao.enable_attrib(attrib.location);
+        if(attrib.integer) {
+            vao.attrib_i_format(attrib.location, attrib.size, attrib.type, attrib.offset);
+        } else {
+            vao.attrib_format(attrib.location, attrib.size, attrib.type, attrib.normalized, attrib.offset);
+        }
+        vao.attrib_binding(attrib.location, attrib.binding);
+    }
+    for(GLuint binding = 0; binding < this->_streams.size(); binding++) {
+        if(this->_streams[binding].divisor != 0) {
+            vao.binding_divisor(binding, this->_streams[binding].divisor);
+        }
+    }
+}
+
+void vertex_format::bind_buffers(vertex_array& vao, std::span<buffer* const> vertex_buffers, std::span<const GLintptr> offsets) const {
+    size_t count = std::min(vertex_buffers.size(), this->_streams.size());
+    for(size_t binding = 0; binding < count; binding++) {
+        if(vertex_buffers[binding] != nullptr) {
+            GLintptr offset = binding < offsets.size() ? offsets[binding] : 0;
+            vao.vertex_buffer(static_cast<GLuint>(binding), *vertex_buffers[binding], offset, this->_streams[binding].stride);
+        }
+    }
+}
+
+std::span<const vertex_format::attribute> vertex_format::attributes() const {
+    return this->_attributes;
+}
+std::span<const vertex_format::stream> vertex_format::streams() const {
+    return this->_streams;
+}
+
+#pragma endregion
+
+#pragma region vertex_array_cache
+
+vertex_array& vertex_array_cache::get(vertex_format const& format, std::span<buffer* const> vertex_buffers, buffer* element_buffer,
+                                      std::span<const GLintptr> offsets) {
+    size_t streams = format.streams().size();
+    //Reused so lookups do not allocate
+    key& lookup = this->_lookup;
+    lookup.clear();
+    lookup.push_back(reinterpret_cast<std::uintptr_t>(&format));
+    for(size_t binding = 0; binding < streams; binding++) {
+        lookup.push_back(binding < vertex_buffers.size() && vertex_buffers[binding] != nullptr ? vertex_buffers[binding]->id() : 0);
+    }
+    for(size_t binding = 0; binding < streams; binding++) {
+        lookup.push_back(binding < offsets.size() ? static_cast<std::uintptr_t>(offsets[binding]) : 0);
+    }
+    lookup.push_back(element_buffer != nullptr ? element_buffer->id() : 0);
+
+    auto found = this->_vertex_arrays.find(lookup);
+    if(found != this->_vertex_arrays.end()) {
+        this->_hits++;
+        return *found->second;
+    }
+
+    this->_misses++;
+    auto added = std::make_unique<vertex_array>();
+    format.apply(*added);
+    format.bind_buffers(*added, vertex_buffers, offsets);
+    if(element_buffer != nullptr) {
+        added->element_buffer(*element_buffer);
+    }
+    return *this->_vertex_arrays.emplace(lookup, std::move(added)).first->second;
+}
+
+void vertex_array_cache::erase(buffer& buf) {
+    std::uintptr_t id = buf.id();
+    std::erase_if(this->_vertex_arrays, [id](auto const& entry) {
+        key const& cached = entry.first;
+        size_t streams = reinterpret_cast<vertex_format const*>(cached.front())->streams().size();
+        auto buffers_begin = cached.begin() + 1;
+        return std::find(buffers_begin, buffers_begin + streams, id) != buffers_begin + streams || cached.back() == id;
+    });
+}
+void vertex_array_cache::clear() {
+    this->_vertex_arrays.clear();
+}
+
+vertex_array_cache::statistics vertex_array_cache::stats() const {
+    return {this->_vertex_arrays.size(), this->_hits, this->_misses};
+}
+
+#pragma endregion
+
+}